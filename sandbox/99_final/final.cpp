@@ -1,15 +1,52 @@
 #include "final.h"
 
 #include <stdexcept>
-#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
 #include "volk.h"
 
+#include "comet/core/hash.h"
+
+// CMake中设置为源码目录，着色器在运行时编译
+#ifndef COMET_SHADER_DIR
+#define COMET_SHADER_DIR "."
+#endif
+
 const unsigned int WIDTH = 800;
 const unsigned int HEIGHT = 600;
 
+// 默认同时处理的帧数
+const unsigned int FRAMES_IN_FLIGHT = 2;
+
+// 场景中的绘制数量
+const size_t DRAW_COUNT = 1;
+
+// 帧耗时统计的日志间隔(秒)
+const double FRAME_STATS_INTERVAL = 5.0;
+
+// 离屏模式模拟的刷新率
+const double HEADLESS_REFRESH_RATE = 60.0;
+
+// 动态分辨率的目标GPU耗时(毫秒)和比例范围
+const double TARGET_GPU_TIME = 1000.0 / 60.0;
+const float MIN_RENDER_SCALE = 0.5f;
+const float MAX_RENDER_SCALE = 1.0f;
+// 不热重载时创建管线变体的线程数
+const uint32_t PIPELINE_THREADS = 2;
+
+// 拉伸后的锐化强度，COMET_SHARPNESS可以覆盖，0只做双线性拉伸
+const float UPSCALE_SHARPNESS = 0.5f;
+
+// 异步计算生成的画中画图案的大小(输出像素)
+const uint32_t OVERLAY_SIZE = 256;
+
 // 指定实例支持的校验层
 const std::vector<const char *> validationLayers = {
     "VK_LAYER_KHRONOS_validation"
@@ -42,11 +79,29 @@ void HelloTriangleApplication::run()
 
 void HelloTriangleApplication::initWindow()
 {
-       Window::Properties properties;
+    Window::Properties properties;
     properties.extent = {WIDTH, HEIGHT};
     properties.title = "99_final";
-    properties.resizable = false;
-    m_window = std::make_unique<GlfwWindow>(properties);
+    properties.resizable = true;
+
+    // 没有显示器的渲染节点和CI设置COMET_HEADLESS=1，COMET_HEADLESS_FRAMES限制渲染帧数
+    const char *headless = std::getenv("COMET_HEADLESS");
+    if (headless && std::strcmp(headless, "0") != 0)
+    {
+        properties.mode = Window::Mode::Headless;
+        properties.resizable = false;
+        m_window = std::make_unique<HeadlessWindow>(properties);
+
+        const char *frames = std::getenv("COMET_HEADLESS_FRAMES");
+        if (frames && std::atoi(frames) > 0)
+        {
+            m_headlessFrameLimit = std::atoi(frames);
+        }
+    }
+    else
+    {
+        m_window = std::make_unique<GlfwWindow>(properties);
+    }
 }
 
 void HelloTriangleApplication::initVulkan()
@@ -63,625 +118,972 @@ void HelloTriangleApplication::initVulkan()
     // 创建logical device
     m_device = std::make_unique<Device>(physical_device, m_surface, getRequiredDeviceExtensions());
 
-    // 创建交换链
-    m_swapchain = std::make_unique<Swapchain>(*m_device, m_surface);
+    // 上次运行保存的管线缓存，设备或驱动变化时自动作废
+    const char *pipelineCachePath = std::getenv("COMET_PIPELINE_CACHE");
+    m_pipelineCache = std::make_unique<PipelineCache>(*m_device, pipelineCachePath ? pipelineCachePath : "pipeline_cache.bin");
 
-    createImageViews();
+    // 呈现模式取决于帧调度器的延迟模式
+    createFrameScheduler();
+
+    // 创建交换链，分辨率与窗口帧缓冲一致；渲染线程启动后通过Resize消息更新
+    m_windowExtent = m_window->get_extent();
+    const auto &extent = m_windowExtent;
+    auto presentModes = m_frameScheduler->get_present_mode_priority_list();
+    m_swapChainRequestedExtent = {extent.width, extent.height};
+    m_swapChainLatencyMode = m_frameScheduler->get_latency_mode();
+    if (m_window->get_mode() == Window::Mode::Headless)
+    {
+        // 节奏：COMET_HEADLESS_PACING=fixed/vsync，默认不限速
+        auto pacingMode = PacingMode::Unthrottled;
+        const char *pacing = std::getenv("COMET_HEADLESS_PACING");
+        if (pacing && std::strcmp(pacing, "fixed") == 0)
+        {
+            pacingMode = PacingMode::FixedRate;
+        }
+        else if (pacing && std::strcmp(pacing, "vsync") == 0)
+        {
+            pacingMode = PacingMode::Vsync;
+        }
+
+        m_swapchain = std::make_unique<HeadlessSwapchain>(*m_device, m_swapChainRequestedExtent, VK_FORMAT_R8G8B8A8_SRGB, 3, pacingMode, HEADLESS_REFRESH_RATE,
+                                                          VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+    }
+    else
+    {
+        m_swapchain = std::make_unique<Swapchain>(*m_device, m_surface,
+                                                  presentModes.front(),
+                                                  presentModes,
+                                                  VkSurfaceFormatKHR{VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+                                                  std::vector<VkSurfaceFormatKHR>{{VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+                                                                                  {VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR}},
+                                                  m_swapChainRequestedExtent,
+                                                  3,
+                                                  1,
+                                                  VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
+                                                  std::set<VkImageUsageFlagBits>{VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT});
+    }
+
+    m_resourceCache = std::make_unique<ResourceCache>(*m_device);
+
+    // 场景先渲染到离屏目标，再拉伸并锐化到交换链图像
+    DynamicResolution::Settings settings;
+    settings.target_gpu_time = TARGET_GPU_TIME;
+    settings.min_scale = MIN_RENDER_SCALE;
+    settings.max_scale = MAX_RENDER_SCALE;
+    m_dynamicResolution.set_settings(settings);
+
+    createSwapChainImages();
+
+    createSceneTarget();
 
     createRenderPass();
 
-    createGraphicsPipeline();
+    // 默认使用链接进可执行文件的着色器，启动时不读文件。
+    // 开发时设置COMET_SHADER_HOT_RELOAD=1，在运行时从源文件编译(结果缓存在工作目录)，修改后自动重建管线。
+    // 使用单独的线程，重新编译时不会占用录制线程
+    const char *hotReload = std::getenv("COMET_SHADER_HOT_RELOAD");
+    if (hotReload && std::strcmp(hotReload, "1") == 0)
+    {
+        m_shaderThreadPool = std::make_unique<ThreadPool>(1);
+        m_shaderCompiler = std::make_unique<ShaderCompiler>(*m_shaderThreadPool, "shader_cache");
+        m_pipelineHotReload = std::make_unique<PipelineHotReload>(*m_device, *m_shaderCompiler, *m_shaderThreadPool);
+    }
 
-    createFramebuffers();
+    createGraphicsPipeline();
 
-    createCommandPool();
+    createUpscaler();
 
-    createCommandBuffer();
+    createAsyncCompute();
 
-    createSyncObjects();
+    createFramebuffers();
 }
 
 void HelloTriangleApplication::mainLoop()
 {
+    // 渲染在独立线程进行，窗口被拖动、缩放时事件线程阻塞也不影响渲染
+    std::exception_ptr renderError;
+    std::thread renderThread([this, &renderError]
+                             {
+        try
+        {
+            renderLoop();
+        }
+        catch (...)
+        {
+            renderError = std::current_exception();
+            m_window->close();
+        } });
+
+    // 事件线程只负责处理窗口系统的事件
     while (!m_window->should_close())
     {
-        m_window->process_events();
+        m_window->wait_events();
+    }
+
+    renderThread.join();
 
-        drawFrame();
+    if (renderError)
+    {
+        std::rethrow_exception(renderError);
     }
+}
+
+void HelloTriangleApplication::renderLoop()
+{
+    m_frameStats.set_report_interval(FRAME_STATS_INTERVAL);
+
+    using Clock = std::chrono::steady_clock;
+    bool running = true;
+    while (running)
+    {
+        auto frameStart = Clock::now();
+
+        // 低延迟模式在这里等待GPU，之后再处理窗口消息
+        auto &frame = m_frameScheduler->wait_for_frame();
+
+        // 上次提交已完成，读取这组资源的GPU耗时，据此调整渲染分辨率
+        m_frameTiming = {};
+        m_frameTiming.gpu_time = frame.get_gpu_time();
+        m_dynamicResolution.update(m_frameTiming.gpu_time);
+
+        Window::Event event{};
+        while (m_window->poll_event(event))
+        {
+            switch (event.type)
+            {
+            case Window::Event::Type::Resize:
+                m_windowExtent = event.extent;
+                break;
+            case Window::Event::Type::Close:
+                running = false;
+                break;
+            }
+        }
+
+        if (!running)
+        {
+            break;
+        }
+
+        // 最小化时不渲染，降低轮询频率等待窗口恢复
+        if (m_windowExtent.width == 0 || m_windowExtent.height == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        drawFrame(frame);
+
+        m_frameTiming.cpu_time = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+        m_frameStats.record(m_frameTiming);
+
+        if (m_headlessFrameLimit > 0 && m_frameStats.get_frame_count() >= m_headlessFrameLimit)
+        {
+            m_window->close();
+            running = false;
+        }
+    }
+
+    // 整个运行期间的统计，便于比较离屏和窗口的结果
+    m_frameStats.log_summary(m_frameStats.get_frame_count());
 
     vkDeviceWaitIdle(m_device->get_handle());
 }
 
 void HelloTriangleApplication::cleanup()
 {
-    // 销毁同步对象
-    vkDestroySemaphore(m_device->get_handle(), m_renderFinishedSemaphore, nullptr);
-    vkDestroySemaphore(m_device->get_handle(), m_imageAvailableSemaphore, nullptr);
-    vkDestroyFence(m_device->get_handle(), m_inFlightFence, nullptr);
-
-    // 销毁命令池
-    vkDestroyCommandPool(m_device->get_handle(), m_commandPool, nullptr);
-
-    // 销毁帧缓冲
-    for (auto framebuffer: m_swapChainFramebuffers)
+    // 销毁命令池和同步对象
+    m_asyncComputeScheduler.reset();
+    m_frameScheduler.reset();
+    m_renderGraph.reset();
+    m_indirectBatcher.reset();
+    m_indexBuffer.reset();
+    m_staticCommandCache.reset();
+    m_parallelRecorder.reset();
+    m_recordThreadPool.reset();
+
+    // 释放帧缓冲
+    m_sceneFramebuffer.reset();
+
+    // 拉伸管线交给延迟删除队列
+    m_upscaler.reset();
+
+    // 设备已经空闲，直接销毁
+    m_overlayDescriptorPool.reset();
+    m_overlayView.reset();
+    m_overlayPipeline.reset();
+
+    // 等待后台重建完成，图形管线交给延迟删除队列
+    if (m_pipelineHotReload)
     {
-        vkDestroyFramebuffer(m_device->get_handle(), framebuffer, nullptr);
+        m_pipelineHotReload.reset();
+        m_shaderCompiler.reset();
+        m_shaderThreadPool.reset();
     }
+    else
+    {
+        // 等待后台创建完成，管线交给延迟删除队列
+        m_pipelineRegistry.reset();
+        m_pipelineThreadPool.reset();
+    }
+    m_graphicsPipeline = VK_NULL_HANDLE;
 
-    // 销毁图形管线
-    vkDestroyPipeline(m_device->get_handle(), m_graphicsPipeline, nullptr);
+    // 释放管线布局，最后的引用释放时销毁
+    m_pipelineLayout.reset();
 
-    // 销毁管线布局
-    vkDestroyPipelineLayout(m_device->get_handle(), m_pipelineLayout, nullptr);
+    // 释放渲染通道
+    m_renderPass.reset();
 
-    // 销毁渲染通道
-    vkDestroyRenderPass(m_device->get_handle(), m_renderPass, nullptr);
+    // 保存运行期间新编译的管线
+    m_pipelineCache->save();
+    m_pipelineCache.reset();
 
-    // 销毁图像视图
-    for (auto imageView: m_swapChainImageViews)
-    {
-        vkDestroyImageView(m_device->get_handle(), imageView, nullptr);
-    }
+    // 销毁延迟删除的旧交换链，设备已经空闲，不会等待
+    m_device->get_deletion_queue().flush();
+
+    // 销毁图像视图和图像
+    m_sceneImageView.reset();
+    m_sceneImage.reset();
+    m_swapChainImageViews.clear();
+    m_swapChainImages.clear();
+    m_resourceCache.reset();
 
     m_swapchain.reset();
 
     m_device.reset();
 
-    vkDestroySurfaceKHR(m_instance->get_handle(), m_surface, nullptr);
+    // 离屏模式没有表面，也没有启用VK_KHR_surface
+    if (m_surface != VK_NULL_HANDLE)
+    {
+        vkDestroySurfaceKHR(m_instance->get_handle(), m_surface, nullptr);
+    }
 
     m_instance.reset();
 
     m_window.reset();
 }
 
-void HelloTriangleApplication::createImageViews()
+void HelloTriangleApplication::createSwapChainImages()
 {
     const auto& swapchain_images = m_swapchain->get_images();
+    const auto& extent = m_swapchain->get_extent();
 
-    // 分配图像视图空间
-    m_swapChainImageViews.resize(swapchain_images.size());
-    // 便利交换链图像，创建图像视图
-    for (unsigned int i = 0; i < swapchain_images.size(); i++)
-    {
-        // 创建图像视图信息
-        VkImageViewCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        createInfo.image = swapchain_images[i];
-        createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        createInfo.format = m_swapchain->get_format();
-        // 设置图像视图的通道映射
-        createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-        createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-        createInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-        createInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
-
-        // 设置图像视图的子资源范围
-        createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        // 图像的mipmap层级
-        createInfo.subresourceRange.baseMipLevel = 0;
-        // 图像的mipmap层级数量
-        createInfo.subresourceRange.levelCount = 1;
-        // 图像的数组层级，用于三维图像
-        createInfo.subresourceRange.baseArrayLayer = 0;
-        // 图像的数组层级数量
-        createInfo.subresourceRange.layerCount = 1;
-
-        // 创建图像视图
-        if (vkCreateImageView(m_device->get_handle(), &createInfo, nullptr, &m_swapChainImageViews[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create image views!");
-        }
+    m_swapChainImageViews.clear();
+    m_swapChainImages.clear();
+    // 遍历交换链图像，包装成Image以便跟踪布局；视图是拉伸的颜色附件
+    for (auto swapchain_image : swapchain_images)
+    {
+        m_swapChainImages.push_back(std::make_unique<Image>(*m_device, swapchain_image, VkExtent3D{extent.width, extent.height, 1},
+                                                            m_swapchain->get_format(), m_swapchain->get_usage()));
+        m_swapChainImageViews.push_back(m_resourceCache->request_image_view(*m_swapChainImages.back(), VK_IMAGE_VIEW_TYPE_2D));
     }
 }
 
+void HelloTriangleApplication::createSceneTarget()
+{
+    // 按最大比例分配，分辨率变化时只改变渲染区域；异步计算的图案复制到场景中
+    auto extent = m_dynamicResolution.get_max_extent(m_swapchain->get_extent());
+    m_sceneImage = std::make_unique<Image>(*m_device, VkExtent3D{extent.width, extent.height, 1}, m_swapchain->get_format(),
+                                           VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                           VMA_MEMORY_USAGE_GPU_ONLY);
+    m_sceneImageView = m_resourceCache->request_image_view(*m_sceneImage, VK_IMAGE_VIEW_TYPE_2D);
+}
+
 void HelloTriangleApplication::createRenderPass()
 {
-    // 创建颜色附件描述信息
-    VkAttachmentDescription colorAttachment{};
-    // 附件的格式
-    colorAttachment.format = m_swapchain->get_format();
-    // 附件的采样数(MSAA)
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    // 附件的加载操作，用于颜色和深度附件
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    // 附件的存储操作，用于颜色和深度附件
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    // 附件的加载操作，用于模板附件
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    // 附件的存储操作，用于模板附件
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    // 附件的初始布局
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    // 附件的最终布局
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    // 创建颜色附件引用
-    VkAttachmentReference colorAttachmentRef{};
-    // 附件的索引
-    colorAttachmentRef.attachment = 0;
-    // 附件的布局
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    // 创建渲染子过程描述信息
-    VkSubpassDescription subpass{};
-    // 渲染子过程的类型
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    // 渲染子过程的颜色附件引用
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-
-    // 创建子过程依赖
-    VkSubpassDependency dependency{};
-    // 依赖的源子过程索引
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    // 依赖的目标子过程索引
-    dependency.dstSubpass = 0;
-    // 依赖的源阶段掩码
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    // 依赖的源访问掩码
-    dependency.srcAccessMask = 0;
-    // 依赖的目标阶段掩码
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    // 依赖的目标访问掩码
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-    // 创建渲染过程描述信息
-    VkRenderPassCreateInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    // 渲染过程的颜色附件描述信息
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
-    // 渲染过程的渲染子过程描述信息
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-    // 渲染过程的子过程依赖
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
-
-    // 创建渲染过程
-    if (vkCreateRenderPass(m_device->get_handle(), &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to create render pass!");
+    m_sceneFormat = m_swapchain->get_format();
+
+    const char *dynamicRendering = std::getenv("COMET_DYNAMIC_RENDERING");
+    m_dynamicRendering = m_device->is_dynamic_rendering_enabled() && !(dynamicRendering && std::strcmp(dynamicRendering, "0") == 0);
+    if (m_dynamicRendering)
+    {
+        return;
     }
+
+    // 颜色附件：每帧清除并保存，布局转换由渲染图的屏障完成
+    RenderPassAttachment colorAttachment{};
+    colorAttachment.format = m_sceneFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.load_op = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.store_op = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.initial_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.final_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    RenderPassDesc desc{};
+    desc.color_attachments = {colorAttachment};
+    m_renderPass = m_resourceCache->request_render_pass(desc);
 }
 
 void HelloTriangleApplication::createGraphicsPipeline()
 {
-    // 读取着色器文件
-    auto vertShaderCode = readFile("/home/jyxiong/Learnings/comet/build/bin/shaders/vert.spv");
-    auto fragShaderCode = readFile("/home/jyxiong/Learnings/comet/build/bin/shaders/frag.spv");
-
-    // 创建着色器模块
-    VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-    VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
-
-    // 创建顶点着色器阶段信息
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    // 创建片段着色器阶段信息
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    // 着色器阶段信息列表
-    VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
-
-    // 顶点输入阶段信息
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 0;
-    vertexInputInfo.pVertexBindingDescriptions = nullptr;
-    vertexInputInfo.vertexAttributeDescriptionCount = 0;
-    vertexInputInfo.pVertexAttributeDescriptions = nullptr;
-
-    // 输入装配阶段信息
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    // 视口和裁剪信息
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float) m_swapchain->get_extent().width;
-    viewport.height = (float) m_swapchain->get_extent().height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = { 0, 0 };
-    scissor.extent = m_swapchain->get_extent();
-
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    // 视口信息
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    // 裁剪信息
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    // 光栅化阶段信息
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    // 指定是否clamp深度值，否则丢弃深度值超出范围的片段
-    rasterizer.depthClampEnable = VK_FALSE;
-    // 指定是否禁止光栅化阶段输出图元
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    // 指定图元的填充模式
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    // 指定面剔除模式
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    // 指定顶点的绘制顺序
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-    // 指定是否开启深度偏移
-    rasterizer.depthBiasEnable = VK_FALSE;
-
-    // 多重采样阶段信息
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    // 指定是否开启多重采样
-    multisampling.sampleShadingEnable = VK_FALSE;
-    // 指定多重采样的采样级别
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-    multisampling.minSampleShading = 1.0f;
-    multisampling.pSampleMask = nullptr;
-    multisampling.alphaToCoverageEnable = VK_FALSE;
-    multisampling.alphaToOneEnable = VK_FALSE;
-
-    // 深度模板测试阶段信息
-
-    // 颜色混合阶段信息方式一：单独指定每个颜色附件的混合状态
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    // 指定颜色混合附件的通道
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    // 指定是否开启颜色混合
-    colorBlendAttachment.blendEnable = VK_FALSE;
-    // 指定颜色混合因子
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-    // 指定颜色混合操作
-    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-    // 指定alpha混合因子
-    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    // 指定alpha混合操作
-    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-
-    // 颜色混合阶段信息方式二：指定全局的混合状态
-    VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    // 指定是否开启全局颜色混合
-    colorBlending.logicOpEnable = VK_FALSE;
-    // 指定逻辑操作
-    colorBlending.logicOp = VK_LOGIC_OP_COPY;
-    // 指定混合附件的数量
-    colorBlending.attachmentCount = 1;
-    // 指定混合附件的状态
-    colorBlending.pAttachments = &colorBlendAttachment;
-    // 指定混合常量
-    colorBlending.blendConstants[0] = 0.0f;
-    colorBlending.blendConstants[1] = 0.0f;
-    colorBlending.blendConstants[2] = 0.0f;
-    colorBlending.blendConstants[3] = 0.0f;
-
-    // 动态状态：指定可以在绘制命令中修改的状态
-    std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-    VkPipelineDynamicStateCreateInfo dynamicState{};
-    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = dynamicStates.size();
-    dynamicState.pDynamicStates = dynamicStates.data();
-
-    // 创建管线布局
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 0;
-    pipelineLayoutInfo.pSetLayouts = nullptr;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-    pipelineLayoutInfo.pPushConstantRanges = nullptr;
-    if (vkCreatePipelineLayout(m_device->get_handle(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to create pipeline layout!");
-    }
-
-    // 创建图形管线
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    // 指定管线阶段的数量
-    pipelineInfo.stageCount = 2;
-    // 指定管线阶段的信息
-    pipelineInfo.pStages = shaderStages;
-    // 指定顶点输入阶段的信息
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    // 指定输入装配阶段的信息
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    // 指定视口和裁剪矩形阶段的信息
-    pipelineInfo.pViewportState = &viewportState;
-    // 指定光栅化阶段的信息
-    pipelineInfo.pRasterizationState = &rasterizer;
-    // 指定多重采样阶段的信息
-    pipelineInfo.pMultisampleState = &multisampling;
-    // 指定深度模板测试阶段的信息
-    pipelineInfo.pDepthStencilState = nullptr;
-    // 指定颜色混合阶段的信息
-    pipelineInfo.pColorBlendState = &colorBlending;
-    // 指定动态状态的信息
-    pipelineInfo.pDynamicState = &dynamicState;
-    // 指定管线布局
-    pipelineInfo.layout = m_pipelineLayout;
-    // 指定渲染目标
-    pipelineInfo.renderPass = m_renderPass;
-    // 指定子管线索引
-    pipelineInfo.subpass = 0;
-    // 指定基础管线句柄
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    // 指定基础管线索引
-    pipelineInfo.basePipelineIndex = -1;
-    // 创建图形管线
-    if (vkCreateGraphicsPipelines(m_device->get_handle(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to create graphics pipeline!");
-    }
-
-    // 销毁着色器模块
-    vkDestroyShaderModule(m_device->get_handle(), fragShaderModule, nullptr);
-    vkDestroyShaderModule(m_device->get_handle(), vertShaderModule, nullptr);
+    const std::filesystem::path shaderDir = COMET_SHADER_DIR;
+    const std::vector<ShaderVariant> variants = {{shaderDir / "final.vert", VK_SHADER_STAGE_VERTEX_BIT},
+                                                 {shaderDir / "final.frag", VK_SHADER_STAGE_FRAGMENT_BIT}};
+    std::vector<ShaderBinary> shaders;
+    for (const auto &variant : variants)
+    {
+        shaders.push_back(m_shaderCompiler ? m_shaderCompiler->compile(variant) : EmbeddedShaders::get(variant.path.filename().string()));
+    }
+
+    // 管线布局由着色器反射生成，各阶段合并后在缓存中去重
+    ShaderReflection reflection(shaders[0].spirv);
+    reflection.merge(ShaderReflection(shaders[1].spirv));
+    m_pipelineLayout = m_resourceCache->request_pipeline_layout(reflection);
+
+    // COMET_GRAYSCALE=1通过特化常量选择灰度变体，不需要另外编译一份着色器
+    const char *grayscale = std::getenv("COMET_GRAYSCALE");
+    m_grayscale = grayscale && std::strcmp(grayscale, "1") == 0;
+
+    if (m_pipelineHotReload)
+    {
+        // 着色器修改后在后台重建管线，渲染线程在帧边界换上。
+        // 重建使用单独的缓存，保存时主缓存不会同时被重建线程使用
+        m_hotReloadPipelineCache = m_pipelineCache->create_worker_cache();
+        m_graphicsPipelineId = m_pipelineHotReload->add("final", variants,
+                                                        [this](const std::vector<ShaderBinary> &shaders)
+                                                        { return buildGraphicsPipeline(shaders); });
+        m_graphicsPipeline = m_pipelineHotReload->get_pipeline(m_graphicsPipelineId);
+    }
+    else
+    {
+        // 管线在注册表的线程池中创建。默认变体是后备，启动时等它完成；
+        // 灰度变体编译完成前先用默认变体绘制，不阻塞渲染线程
+        m_pipelineThreadPool = std::make_unique<ThreadPool>(PIPELINE_THREADS);
+        m_pipelineRegistry = std::make_unique<PipelineRegistry>(*m_device, *m_pipelineCache, *m_pipelineThreadPool);
+        m_defaultPipeline = m_pipelineRegistry->request(describeGraphicsPipeline(shaders, false));
+        m_variantPipeline = m_grayscale ? m_pipelineRegistry->request(describeGraphicsPipeline(shaders, true)) : m_defaultPipeline;
+
+        m_graphicsPipeline = m_pipelineRegistry->wait(m_defaultPipeline);
+        if (m_graphicsPipeline == VK_NULL_HANDLE)
+        {
+            throw std::runtime_error("failed to create graphics pipeline!");
+        }
+    }
+
+    // 编译完马上保存，异常退出也不会丢失
+    m_pipelineCache->save();
 }
 
-std::vector<char> HelloTriangleApplication::readFile(const std::filesystem::path &filename)
+VkPipeline HelloTriangleApplication::buildGraphicsPipeline(const std::vector<ShaderBinary> &shaders)
 {
-    if (!std::filesystem::exists(filename))
+    // 录制命令时使用的布局不会跟着热重载更换，着色器的资源接口变化时保留旧管线
+    ShaderReflection reflection(shaders[0].spirv);
+    reflection.merge(ShaderReflection(shaders[1].spirv));
+    if (m_resourceCache->request_pipeline_layout(reflection) != m_pipelineLayout)
     {
-        throw std::runtime_error("file not found!");
+        throw std::runtime_error("pipeline layout changed, restart to apply!");
     }
 
-    // 打开文件：从尾部开始读取，二进制格式
-    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    // 热重载在自己的线程中创建并持有管线，不需要经过注册表的线程池
+    return PipelineRegistry::create_graphics_pipeline(*m_device, m_hotReloadPipelineCache, describeGraphicsPipeline(shaders, m_grayscale));
+}
+
+GraphicsPipelineDesc HelloTriangleApplication::describeGraphicsPipeline(const std::vector<ShaderBinary> &shaders, bool grayscale)
+{
+    ShaderReflection vertReflection(shaders[0].spirv);
+    ShaderReflection fragReflection(shaders[1].spirv);
+
+    // 完整的管线状态，由注册表的创建函数展开成VkGraphicsPipelineCreateInfo
+    GraphicsPipelineDesc desc{};
+    desc.shaders = {{VK_SHADER_STAGE_VERTEX_BIT, shaders[0].spirv},
+                    {VK_SHADER_STAGE_FRAGMENT_BIT, shaders[1].spirv}};
 
-    if (!file.is_open())
+    // 片段着色器的特化常量，热重载后如果着色器不再声明它会保留旧管线
+    desc.shaders[1].specialization.set(0, grayscale);
+    desc.shaders[1].specialization.check(fragReflection);
+
+    // 顶点着色器的输入紧密排列在一个绑定中
+    desc.vertex_attributes = vertReflection.get_vertex_attributes();
+    if (!desc.vertex_attributes.empty())
     {
-        throw std::runtime_error("failed to open file!");
+        desc.vertex_bindings = {vertReflection.get_vertex_binding()};
     }
 
-    // 从尾部开始读取文件，能够获取文件大小
-    auto fileSize = file.tellg();
-    std::vector<char> buffer(fileSize);
+    desc.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    desc.cull_mode = VK_CULL_MODE_BACK_BIT;
+    desc.front_face = VK_FRONT_FACE_CLOCKWISE;
 
-    // 从文件头开始读取文件内容
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
+    // 不混合，写入所有通道
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_FALSE;
+    desc.blend_attachments = {colorBlendAttachment};
 
-    file.close();
+    desc.layout = m_pipelineLayout;
+    desc.render_pass = m_renderPass;
+    desc.subpass = 0;
+    desc.color_formats = {m_sceneFormat};
 
-    return buffer;
+    return desc;
 }
 
-VkShaderModule HelloTriangleApplication::createShaderModule(const std::vector<char> &code)
+void HelloTriangleApplication::createUpscaler()
 {
-    // 创建着色器模块信息
-    VkShaderModuleCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = code.size();
-    // 着色器代码的字节码指针类型转换
-    createInfo.pCode = reinterpret_cast<const unsigned int *>(code.data());
+    const std::filesystem::path shaderDir = COMET_SHADER_DIR;
+    const std::vector<ShaderVariant> variants = {{shaderDir / "upscale.vert", VK_SHADER_STAGE_VERTEX_BIT},
+                                                 {shaderDir / "upscale.frag", VK_SHADER_STAGE_FRAGMENT_BIT}};
+    std::vector<ShaderBinary> shaders;
+    for (const auto &variant : variants)
+    {
+        shaders.push_back(m_shaderCompiler ? m_shaderCompiler->compile(variant) : EmbeddedShaders::get(variant.path.filename().string()));
+    }
+
+    m_upscaler = std::make_unique<Upscaler>(*m_device, *m_resourceCache, m_pipelineCache->get_handle(),
+                                            shaders[0].spirv, shaders[1].spirv, m_swapchain->get_format(), m_dynamicRendering);
 
-    // 创建着色器模块
-    VkShaderModule shaderModule;
-    if (vkCreateShaderModule(m_device->get_handle(), &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
+    float sharpness = UPSCALE_SHARPNESS;
+    const char *sharpnessEnv = std::getenv("COMET_SHARPNESS");
+    if (sharpnessEnv)
     {
-        throw std::runtime_error("failed to create shader module!");
+        sharpness = static_cast<float>(std::atof(sharpnessEnv));
     }
+    m_upscaler->set_sharpness(sharpness);
 
-    return shaderModule;
+    m_upscaler->set_source(m_sceneImageView);
+    m_upscaler->set_targets(m_swapChainImageViews);
 }
 
-void HelloTriangleApplication::createFramebuffers()
+void HelloTriangleApplication::createAsyncCompute()
 {
-    m_swapChainFramebuffers.resize(m_swapChainImageViews.size());
-
-    for (size_t i = 0; i < m_swapChainImageViews.size(); i++)
+    const char *asyncCompute = std::getenv("COMET_ASYNC_COMPUTE");
+    if (!asyncCompute || std::strcmp(asyncCompute, "1") != 0)
     {
-        VkImageView attachments[] = { m_swapChainImageViews[i] };
-
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = m_renderPass;
-        framebufferInfo.attachmentCount = 1;
-        framebufferInfo.pAttachments = attachments;
-        framebufferInfo.width = m_swapchain->get_extent().width;
-        framebufferInfo.height = m_swapchain->get_extent().height;
-        framebufferInfo.layers = 1;
+        return;
+    }
 
-        if (vkCreateFramebuffer(m_device->get_handle(), &framebufferInfo, nullptr, &m_swapChainFramebuffers[i]) != VK_SUCCESS)
+    // 优先使用没有图形能力的计算队列族，没有时与图形队列共用一个族
+    Queue *computeQueue = nullptr;
+    for (const auto &family : m_device->get_queues())
+    {
+        if (computeQueue == nullptr && !family.empty())
         {
-            throw std::runtime_error("failed to create framebuffer!");
+            auto flags = family[0].get_properties().queueFlags;
+            if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+            {
+                computeQueue = &m_device->get_queue(family[0].get_family_index(), 0);
+            }
         }
     }
+    if (computeQueue == nullptr)
+    {
+        computeQueue = &m_device->get_queue_by_flags(VK_QUEUE_COMPUTE_BIT, 0);
+    }
+
+    m_asyncComputeScheduler = std::make_unique<FrameScheduler>(*m_device, *computeQueue, m_frameScheduler->get_frames_in_flight(),
+                                                               m_frameScheduler->get_latency_mode());
+
+    const std::filesystem::path shaderDir = COMET_SHADER_DIR;
+    const ShaderVariant variant{shaderDir / "overlay.comp", VK_SHADER_STAGE_COMPUTE_BIT};
+    auto shader = m_shaderCompiler ? m_shaderCompiler->compile(variant) : EmbeddedShaders::get(variant.path.filename().string());
+
+    m_overlayPipeline = std::make_unique<ComputePipeline>(*m_device, m_pipelineCache->get_handle(),
+                                                          m_resourceCache->request_pipeline_layout(ShaderReflection(shader.spirv)),
+                                                          shader.spirv);
+    m_overlayStartTime = std::chrono::steady_clock::now();
 }
 
-void HelloTriangleApplication::createCommandPool()
+void HelloTriangleApplication::createFramebuffers()
 {
-    auto queueFamilyIndices = m_device->find_queue_family();
-
-    VkCommandPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    // 指定命令池分配的命令缓冲区，对应的队列族
-    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
-    // 指令池分配的命令缓冲区互相独立
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    // 创建指令池
-    if (vkCreateCommandPool(m_device->get_handle(), &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS)
+    if (!m_renderPass)
     {
-        throw std::runtime_error("failed to create command pool!");
+        return;
     }
+
+    // 视图和大小不变时得到同一个帧缓冲
+    auto extent = m_sceneImage->get_extent();
+    m_sceneFramebuffer = m_resourceCache->request_framebuffer(m_renderPass, {m_sceneImageView}, {extent.width, extent.height});
 }
 
-void HelloTriangleApplication::createCommandBuffer()
+void HelloTriangleApplication::createFrameScheduler()
 {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    // 指定指令池
-    allocInfo.commandPool = m_commandPool;
-    // 指定为主命令缓冲区
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
+    auto queueFamilyIndices = m_device->find_queue_family();
 
-    if (vkAllocateCommandBuffers(m_device->get_handle(), &allocInfo, &m_commandBuffer) != VK_SUCCESS)
+    // 批处理部署设置COMET_LATENCY_MODE=throughput，交互使用默认的低延迟模式
+    auto latencyMode = LatencyMode::LowLatency;
+    const char *mode = std::getenv("COMET_LATENCY_MODE");
+    if (mode && std::strcmp(mode, "throughput") == 0)
     {
-        throw std::runtime_error("failed to allocate command buffers!");
+        latencyMode = LatencyMode::Throughput;
     }
-}
 
-void HelloTriangleApplication::createSyncObjects()
-{
-    VkSemaphoreCreateInfo semaphoreInfo{};
-    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    unsigned int framesInFlight = FRAMES_IN_FLIGHT;
+    const char *frames = std::getenv("COMET_FRAMES_IN_FLIGHT");
+    if (frames && std::atoi(frames) > 0)
+    {
+        framesInFlight = std::atoi(frames);
+    }
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    // 默认留出渲染线程自身，其余核心都用于录制
+    unsigned int recordThreads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    const char *threads = std::getenv("COMET_RECORD_THREADS");
+    if (threads && std::atoi(threads) >= 0)
+    {
+        recordThreads = std::atoi(threads);
+    }
+    recordThreads = std::max(1u, recordThreads);
 
+    m_recordThreadPool = std::make_unique<ThreadPool>(recordThreads);
+    m_parallelRecorder = std::make_unique<ParallelRecorder>(*m_recordThreadPool);
 
-    if (vkCreateSemaphore(m_device->get_handle(), &semaphoreInfo, nullptr, &m_imageAvailableSemaphore) != VK_SUCCESS ||
-        vkCreateSemaphore(m_device->get_handle(), &semaphoreInfo, nullptr, &m_renderFinishedSemaphore) != VK_SUCCESS ||
-        vkCreateFence(m_device->get_handle(), &fenceInfo, nullptr, &m_inFlightFence) != VK_SUCCESS)
+    const char *staticCommands = std::getenv("COMET_STATIC_COMMANDS");
+    if (staticCommands && std::strcmp(staticCommands, "1") == 0)
     {
-        throw std::runtime_error("failed to create synchronization objects for a frame!");
+        m_staticCommandCache = std::make_unique<StaticCommandCache>(*m_device, queueFamilyIndices.graphicsFamily.value());
     }
 
+    m_renderGraph = std::make_unique<RenderGraph>(*m_device);
+
+    // 每个录制线程每帧一个命令池
+    m_frameScheduler = std::make_unique<FrameScheduler>(*m_device, m_device->get_queue(queueFamilyIndices.graphicsFamily.value(), 0), framesInFlight, latencyMode,
+                                                        m_parallelRecorder->get_required_thread_count());
+
+    // 设置COMET_INDIRECT_DRAWS=1时绘制合并成多重间接绘制
+    const char *indirectDraws = std::getenv("COMET_INDIRECT_DRAWS");
+    if (indirectDraws && std::strcmp(indirectDraws, "1") == 0)
+    {
+        m_indirectBatcher = std::make_unique<IndirectBatcher>(*m_device, m_frameScheduler->get_queue(), DRAW_COUNT);
+
+        // 顶点着色器用gl_VertexIndex取位置，索引就是顶点序号
+        const uint32_t indices[] = {0, 1, 2};
+        m_indexBuffer = std::make_unique<Buffer>(*m_device, sizeof(indices), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        m_indexBuffer->update(indices, sizeof(indices));
+    }
 }
 
-void HelloTriangleApplication::drawFrame()
+void HelloTriangleApplication::drawFrame(FrameContext &frame)
 {
-    // 等待GPU执行完毕
-    vkWaitForFences(m_device->get_handle(), 1, &m_inFlightFence, VK_TRUE, UINT64_MAX);
-    vkResetFences(m_device->get_handle(), 1, &m_inFlightFence);
+    // 销毁GPU已经不再使用的资源
+    m_device->get_deletion_queue().collect();
+
+    // 帧边界：换上后台重建好的管线，这一帧开始使用
+    if (m_pipelineHotReload)
+    {
+        m_pipelineHotReload->update();
+        m_graphicsPipeline = m_pipelineHotReload->get_pipeline(m_graphicsPipelineId);
+    }
+    else
+    {
+        // 变体完成后换上，失败或未完成时继续用默认变体
+        m_graphicsPipeline = m_pipelineRegistry->get(m_variantPipeline, m_defaultPipeline);
+    }
+
+    // 窗口大小或延迟模式变化时主动重建，不等待OUT_OF_DATE
+    const auto &extent = m_windowExtent;
+    if (extent.width != m_swapChainRequestedExtent.width || extent.height != m_swapChainRequestedExtent.height ||
+        m_frameScheduler->get_latency_mode() != m_swapChainLatencyMode)
+    {
+        recreateSwapChain();
+    }
 
     // 获取当前可用的交换链图像
     unsigned int imageIndex;
-    vkAcquireNextImageKHR(m_device->get_handle(), m_swapchain->get_handle(), UINT64_MAX, m_imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
-
-    // 重置命令缓冲区
-    vkResetCommandBuffer(m_commandBuffer, 0);
-    // 记录命令缓冲区
-    recordCommandBuffer(m_commandBuffer, imageIndex);
-
-    // 提交命令缓冲区
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    // 等待信号量
-    VkSemaphore waitSemaphores[] = { m_imageAvailableSemaphore };
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    // 等待管线阶段
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    submitInfo.pWaitDstStageMask = waitStages;
-    // 提交的命令缓冲区
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffer;
-    // 信号量
-    VkSemaphore signalSemaphores[] = { m_renderFinishedSemaphore };
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
-    if (vkQueueSubmit(m_device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_handle(), 1, &submitInfo, m_inFlightFence) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to submit draw command buffer!");
-    }
-
-    // 呈现信息
-    VkPresentInfoKHR presentInfo{};
-    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-    // 等待信号量
-    presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
-    // 交换链
-    VkSwapchainKHR swapChains[] = { m_swapchain->get_handle() };
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = swapChains;
-    // 交换链图像索引
-    presentInfo.pImageIndices = &imageIndex;
-    // 提交队列
-    vkQueuePresentKHR(m_device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_handle(), &presentInfo);
+    auto acquireStart = std::chrono::steady_clock::now();
+    VkResult result = m_swapchain->acquire_next_image(imageIndex, frame.get_image_available_semaphore());
+    m_frameTiming.acquire_wait_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - acquireStart).count();
+    if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    {
+        // 信号量未被使用，这组资源没有新的提交，下一帧可以直接继续
+        recreateSwapChain();
+        return;
+    }
+    else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+    {
+        throw std::runtime_error("failed to acquire swap chain image!");
+    }
+
+    // 确定会提交后再重置命令池
+    frame.reset();
+
+    // 计算队列上这组命令池的上次提交，在图形队列等待它之前已经完成
+    CommandBuffer *asyncCommandBuffer = nullptr;
+    if (m_asyncComputeScheduler)
+    {
+        auto &computeFrame = m_asyncComputeScheduler->wait_for_frame();
+        computeFrame.reset();
+        asyncCommandBuffer = &computeFrame.request_command_buffer();
+    }
+
+    // 从重置后的命令池中复用命令缓冲并记录
+    auto &commandBuffer = frame.request_command_buffer();
+    recordCommandBuffer(frame, commandBuffer, asyncCommandBuffer, imageIndex);
+
+    auto &queue = m_frameScheduler->get_queue();
+    std::vector<TimelineWait> timelineWaits;
+    if (asyncCommandBuffer)
+    {
+        // 异步提交等待图形队列的上一次提交：之前的帧可能仍在读取临时图像
+        auto &computeQueue = m_asyncComputeScheduler->get_queue();
+        uint64_t asyncValue = computeQueue.submit({ asyncCommandBuffer->get_handle() }, {}, {}, {},
+                                                  { { &queue, queue.get_last_submitted_value(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT } });
+        m_asyncComputeScheduler->end_frame(asyncValue);
+
+        // 图形队列在读取异步结果的阶段等待，之前的场景绘制可以与计算重叠
+        if (m_renderGraph->get_async_wait_stages() != 0)
+        {
+            timelineWaits.push_back({ &computeQueue, asyncValue, m_renderGraph->get_async_wait_stages() });
+        }
+    }
+
+    // 提交命令缓冲区：等待图像获取，完成后触发渲染完成信号量；
+    // 交换链图像第一次使用是拉伸时的颜色附件写入
+    uint64_t submittedValue = queue.submit({ commandBuffer.get_handle() },
+                                           { frame.get_image_available_semaphore() },
+                                           { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT },
+                                           { frame.get_render_finished_semaphore() },
+                                           timelineWaits);
+    m_frameScheduler->end_frame(submittedValue);
+
+    // 呈现：等待渲染完成的信号量
+    auto presentStart = std::chrono::steady_clock::now();
+    result = m_swapchain->present(queue.get_handle(), imageIndex, frame.get_render_finished_semaphore());
+    m_frameTiming.present_wait_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - presentStart).count();
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+    {
+        recreateSwapChain();
+    }
+    else if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to present swap chain image!");
+    }
 }
 
-void HelloTriangleApplication::recordCommandBuffer(VkCommandBuffer commandBuffer, unsigned int imageIndex)
+void HelloTriangleApplication::recordCommandBuffer(FrameContext &frame, CommandBuffer &commandBufferObject, CommandBuffer *asyncCommandBuffer,
+                                                   unsigned int imageIndex)
 {
-    // 开始记录命令
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = 0;
-    beginInfo.pInheritanceInfo = nullptr;
-    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to begin recording command buffer!");
-    }
-
-    // 渲染流程信息
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = m_renderPass;
-    renderPassInfo.framebuffer = m_swapChainFramebuffers[imageIndex];
-    renderPassInfo.renderArea.offset = { 0, 0 };
-    renderPassInfo.renderArea.extent = m_swapchain->get_extent();
-    // 清除颜色
-    VkClearValue clearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
-    // 开始渲染流程
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-    // 绑定图形管线
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
-
-    {
-        // 动态视口
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = (float)m_swapchain->get_extent().width;
-        viewport.height = (float)m_swapchain->get_extent().height;
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-        // 动态裁剪
-        VkRect2D scissor{};
-        scissor.offset = { 0, 0 };
-        scissor.extent = m_swapchain->get_extent();
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-    }
-
-    // 绘制
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
-    // 结束渲染流程
-    vkCmdEndRenderPass(commandBuffer);
+    VkCommandBuffer commandBuffer = commandBufferObject.get_handle();
+
+    // 开始记录命令，每帧重新录制，只提交一次
+    commandBufferObject.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    if (asyncCommandBuffer)
+    {
+        asyncCommandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    }
+
+    // GPU耗时
+    frame.begin_timer(commandBuffer);
+
+    // 当前比例下的渲染分辨率，只使用场景目标左上角的区域
+    VkExtent2D renderExtent = m_dynamicResolution.get_render_extent(m_swapchain->get_extent());
+
+    // 刚获取的交换链图像内容未定义，等待获取信号量的阶段是颜色附件输出
+    auto &swapChainImage = *m_swapChainImages[imageIndex];
+    swapChainImage.set_state({VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+                             {VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_NONE_KHR});
+
+    m_renderGraph->reset();
+    auto scene = m_renderGraph->import_image("scene", *m_sceneImage);
+    auto backbuffer = m_renderGraph->import_image("backbuffer", swapChainImage);
+
+    // 场景目标整帧重绘，不需要保留上一帧的内容
+    m_renderGraph->add_pass("scene", RenderGraphQueue::Graphics,
+                            [scene](RenderGraph::PassBuilder &builder)
+                            {
+                                builder.write(scene, {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR}, true);
+                            },
+                            [this, &frame, renderExtent](CommandBuffer &commandBufferObject, RenderGraph &)
+                            {
+                                VkCommandBuffer commandBuffer = commandBufferObject.get_handle();
+
+                                // 清除颜色
+                                VkClearValue clearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+                                // 绘制全部录制在次级命令缓冲中
+                                VkCommandBufferInheritanceInfo inheritanceInfo{};
+                                inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+                                VkCommandBufferInheritanceRenderingInfoKHR renderingInheritance{};
+                                if (m_dynamicRendering)
+                                {
+                                    // 动态渲染直接使用图像视图，不需要渲染通道和帧缓冲
+                                    VkRenderingAttachmentInfoKHR colorAttachment{};
+                                    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+                                    colorAttachment.imageView = m_sceneImageView->get_handle();
+                                    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                                    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                                    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                                    colorAttachment.clearValue = clearColor;
+
+                                    VkRenderingInfoKHR renderingInfo{};
+                                    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+                                    renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR;
+                                    renderingInfo.renderArea.offset = { 0, 0 };
+                                    renderingInfo.renderArea.extent = renderExtent;
+                                    renderingInfo.layerCount = 1;
+                                    renderingInfo.colorAttachmentCount = 1;
+                                    renderingInfo.pColorAttachments = &colorAttachment;
+                                    vkCmdBeginRenderingKHR(commandBuffer, &renderingInfo);
+
+                                    // 次级命令缓冲通过继承信息得知附件格式
+                                    renderingInheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+                                    renderingInheritance.colorAttachmentCount = 1;
+                                    renderingInheritance.pColorAttachmentFormats = &m_sceneFormat;
+                                    renderingInheritance.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+                                    inheritanceInfo.pNext = &renderingInheritance;
+                                }
+                                else
+                                {
+                                    // 渲染流程信息
+                                    VkRenderPassBeginInfo renderPassInfo{};
+                                    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                                    renderPassInfo.renderPass = m_renderPass->get_handle();
+                                    renderPassInfo.framebuffer = m_sceneFramebuffer->get_handle();
+                                    renderPassInfo.renderArea.offset = { 0, 0 };
+                                    renderPassInfo.renderArea.extent = renderExtent;
+                                    renderPassInfo.clearValueCount = 1;
+                                    renderPassInfo.pClearValues = &clearColor;
+                                    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+                                    inheritanceInfo.renderPass = m_renderPass->get_handle();
+                                    inheritanceInfo.subpass = 0;
+                                    inheritanceInfo.framebuffer = m_sceneFramebuffer->get_handle();
+                                }
+
+                                // 次级命令缓冲不继承动态状态，需要自己设置
+                                auto setViewport = [renderExtent](VkCommandBuffer secondaryBuffer)
+                                {
+                                    // 动态视口
+                                    VkViewport viewport{};
+                                    viewport.x = 0.0f;
+                                    viewport.y = 0.0f;
+                                    viewport.width = (float)renderExtent.width;
+                                    viewport.height = (float)renderExtent.height;
+                                    viewport.minDepth = 0.0f;
+                                    viewport.maxDepth = 1.0f;
+                                    vkCmdSetViewport(secondaryBuffer, 0, 1, &viewport);
+
+                                    // 动态裁剪
+                                    VkRect2D scissor{};
+                                    scissor.offset = { 0, 0 };
+                                    scissor.extent = renderExtent;
+                                    vkCmdSetScissor(secondaryBuffer, 0, 1, &scissor);
+                                };
+
+                                auto drawScene = [this, &setViewport](CommandBuffer &secondary, size_t begin, size_t end)
+                                {
+                                    VkCommandBuffer secondaryBuffer = secondary.get_handle();
+
+                                    // 绑定图形管线
+                                    vkCmdBindPipeline(secondaryBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+
+                                    setViewport(secondaryBuffer);
+
+                                    // 绘制
+                                    for (size_t i = begin; i < end; ++i)
+                                    {
+                                        vkCmdDraw(secondaryBuffer, 3, 1, 0, 0);
+                                    }
+                                };
+
+                                if (m_indirectBatcher)
+                                {
+                                    // 所有绘制按管线合并成间接绘制，一个次级命令缓冲就够了
+                                    m_indirectBatcher->begin();
+                                    for (size_t i = 0; i < DRAW_COUNT; ++i)
+                                    {
+                                        m_indirectBatcher->add(m_graphicsPipeline, {3, 1, 0, 0, 0});
+                                    }
+                                    m_indirectBatcher->end();
+
+                                    auto &secondary = frame.request_command_buffer(0, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+                                    secondary.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritanceInfo);
+                                    setViewport(secondary.get_handle());
+                                    vkCmdBindIndexBuffer(secondary.get_handle(), m_indexBuffer->get_handle(), 0, VK_INDEX_TYPE_UINT32);
+                                    m_indirectBatcher->record(secondary.get_handle(),
+                                                              [](VkCommandBuffer secondaryBuffer, const IndirectBatcher::Batch &batch)
+                                                              {
+                                                                  vkCmdBindPipeline(secondaryBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, batch.pipeline);
+                                                              });
+                                    secondary.end();
+                                    commandBufferObject.execute_commands(secondary);
+                                }
+                                else if (m_staticCommandCache)
+                                {
+                                    // 内容只取决于管线和渲染分辨率，不变时直接执行上次录制的命令
+                                    size_t contentHash = 0;
+                                    hash_combine(contentHash, m_graphicsPipeline);
+                                    hash_combine(contentHash, renderExtent.width);
+                                    hash_combine(contentHash, renderExtent.height);
+                                    hash_combine(contentHash, DRAW_COUNT);
+                                    auto &sceneCommands = m_staticCommandCache->request("scene", contentHash, inheritanceInfo,
+                                                                                       [&drawScene](CommandBuffer &secondary)
+                                                                                       { drawScene(secondary, 0, DRAW_COUNT); });
+                                    commandBufferObject.execute_commands(sceneCommands);
+                                }
+                                else
+                                {
+                                    // 绘制列表按批分给工作线程
+                                    m_parallelRecorder->record(frame, commandBufferObject, inheritanceInfo, DRAW_COUNT, drawScene);
+                                }
+
+                                // 结束渲染流程
+                                if (m_dynamicRendering)
+                                {
+                                    vkCmdEndRenderingKHR(commandBuffer);
+                                }
+                                else
+                                {
+                                    vkCmdEndRenderPass(commandBuffer);
+                                }
+                            });
+
+    // 图案在异步计算队列上生成，与场景绘制重叠执行；句柄在执行时仍要使用
+    RenderGraphHandle overlay;
+    if (m_asyncComputeScheduler)
+    {
+        m_renderGraph->add_pass("overlay", RenderGraphQueue::AsyncCompute,
+                                [&overlay](RenderGraph::PassBuilder &builder)
+                                {
+                                    overlay = builder.create("overlay", {{OVERLAY_SIZE, OVERLAY_SIZE}, VK_FORMAT_R8G8B8A8_UNORM,
+                                                                         VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT});
+                                    builder.write(overlay, {VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR}, true);
+                                },
+                                [this, &overlay](CommandBuffer &commandBufferObject, RenderGraph &graph)
+                                {
+                                    VkCommandBuffer commandBuffer = commandBufferObject.get_handle();
+
+                                    // 重新分配时旧图像还在延迟删除队列中，新图像的地址一定不同
+                                    auto &image = graph.get_image(overlay);
+                                    if (!m_overlayView || &m_overlayView->get_image() != &image)
+                                    {
+                                        auto &deletionQueue = m_device->get_deletion_queue();
+                                        deletionQueue.retire(std::move(m_overlayDescriptorPool));
+                                        deletionQueue.retire(std::move(m_overlayView));
+
+                                        m_overlayView = m_resourceCache->request_image_view(image, VK_IMAGE_VIEW_TYPE_2D);
+                                        m_overlayDescriptorPool = std::make_unique<DescriptorPool>(*m_device, 1, std::vector<VkDescriptorPoolSize>{{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1}});
+                                        m_overlayDescriptorSet = m_overlayDescriptorPool->allocate(*m_overlayPipeline->get_layout()->get_set_layouts().front());
+
+                                        DescriptorWriter writer;
+                                        writer.write_image(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, *m_overlayView, VK_IMAGE_LAYOUT_GENERAL);
+                                        writer.update(*m_device, m_overlayDescriptorSet);
+                                    }
+
+                                    float time = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_overlayStartTime).count();
+                                    m_overlayPipeline->bind(commandBuffer);
+                                    m_overlayPipeline->bind_descriptor_sets(commandBuffer, 0, {m_overlayDescriptorSet});
+                                    m_overlayPipeline->push_constants(commandBuffer, &time, sizeof(time));
+                                    m_overlayPipeline->dispatch_threads(commandBuffer, OVERLAY_SIZE, OVERLAY_SIZE);
+                                });
+
+        // 按渲染比例缩小后复制到场景左上角，拉伸后在输出中的大小不变
+        m_renderGraph->add_pass("overlay composite", RenderGraphQueue::Graphics,
+                                [overlay, scene](RenderGraph::PassBuilder &builder)
+                                {
+                                    builder.read(overlay, {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR});
+                                    builder.write(scene, {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR});
+                                },
+                                [this, overlay, scene, renderExtent](CommandBuffer &commandBufferObject, RenderGraph &graph)
+                                {
+                                    const auto &outputExtent = m_swapchain->get_extent();
+                                    int32_t width = std::min<int32_t>(OVERLAY_SIZE * renderExtent.width / outputExtent.width, renderExtent.width);
+                                    int32_t height = std::min<int32_t>(OVERLAY_SIZE * renderExtent.height / outputExtent.height, renderExtent.height);
+                                    if (width == 0 || height == 0)
+                                    {
+                                        return;
+                                    }
+
+                                    VkImageBlit region{};
+                                    region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+                                    region.srcOffsets[1] = {static_cast<int32_t>(OVERLAY_SIZE), static_cast<int32_t>(OVERLAY_SIZE), 1};
+                                    region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+                                    region.dstOffsets[1] = {width, height, 1};
+                                    vkCmdBlitImage(commandBufferObject.get_handle(),
+                                                   graph.get_image(overlay).get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                   graph.get_image(scene).get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                   1, &region, VK_FILTER_LINEAR);
+                                });
+    }
+
+    // 双线性拉伸并锐化到交换链图像，之后转换到呈现需要的布局
+    m_renderGraph->add_pass("upscale", RenderGraphQueue::Graphics,
+                            [scene, backbuffer](RenderGraph::PassBuilder &builder)
+                            {
+                                builder.read(scene, Upscaler::get_source_state());
+                                builder.write(backbuffer, Upscaler::get_target_state(), true);
+                            },
+                            [this, renderExtent, imageIndex](CommandBuffer &commandBufferObject, RenderGraph &)
+                            {
+                                m_upscaler->record(commandBufferObject.get_handle(), renderExtent, imageIndex);
+                            });
+
+    m_renderGraph->set_output(backbuffer, {m_swapchain->get_present_layout(), VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR});
+    m_renderGraph->compile();
+    m_renderGraph->execute(commandBufferObject, asyncCommandBuffer);
+
+    frame.end_timer(commandBuffer);
 
     // 结束记录命令
-    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    commandBufferObject.end();
+    if (asyncCommandBuffer)
     {
-        throw std::runtime_error("failed to record command buffer!");
+        asyncCommandBuffer->end();
     }
 }
 
+void HelloTriangleApplication::recreateSwapChain()
+{
+    const auto &extent = m_windowExtent;
+    if (extent.width == 0 || extent.height == 0)
+    {
+        return;
+    }
+
+    // 离屏交换链大小固定，不会过期
+    auto *swapchain = dynamic_cast<Swapchain *>(m_swapchain.get());
+    if (!swapchain)
+    {
+        return;
+    }
+
+    // 以旧交换链为oldSwapchain创建，呈现引擎可以复用其资源
+    auto oldSwapChain = std::move(m_swapchain);
+    auto presentModes = m_frameScheduler->get_present_mode_priority_list();
+    m_swapChainRequestedExtent = {extent.width, extent.height};
+    m_swapChainLatencyMode = m_frameScheduler->get_latency_mode();
+    m_swapchain = std::make_unique<Swapchain>(*swapchain, m_swapChainRequestedExtent, presentModes.front(), presentModes);
+
+    // 旧交换链和场景目标可能仍在被之前的帧使用，GPU完成已提交的工作后再销毁
+    auto &deletionQueue = m_device->get_deletion_queue();
+    deletionQueue.retire(std::move(m_sceneFramebuffer));
+    deletionQueue.retire(std::move(m_sceneImageView));
+    deletionQueue.retire(std::move(m_sceneImage));
+    for (auto &imageView : m_swapChainImageViews)
+    {
+        deletionQueue.retire(std::move(imageView));
+    }
+    m_swapChainImageViews.clear();
+    for (auto &image : m_swapChainImages)
+    {
+        deletionQueue.retire(std::move(image));
+    }
+    m_swapChainImages.clear();
+    deletionQueue.retire(std::move(oldSwapChain));
+
+    // 缓存的命令缓冲引用了旧的帧缓冲
+    if (m_staticCommandCache)
+    {
+        m_staticCommandCache->clear();
+    }
+
+    // 管线使用动态视口和裁剪，渲染通道只依赖格式，都不需要重建；帧缓冲随场景视图从缓存中取得
+    createSwapChainImages();
+
+    createSceneTarget();
+
+    // 拉伸的描述符和帧缓冲引用了旧的视图，旧的交给延迟删除队列
+    m_upscaler->set_source(m_sceneImageView);
+    m_upscaler->set_targets(m_swapChainImageViews);
+
+    createFramebuffers();
+}
+
 std::vector<const char *> HelloTriangleApplication::getRequiredInstanceExtensions()
 {
     std::vector<const char *> extensions;
 
-    // 获取glfw需要的扩展
-    unsigned int glfwExtensionCount = 0;
-    const char **glfwExtensions;
-    glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-    extensions.insert(extensions.end(), glfwExtensions, glfwExtensions + glfwExtensionCount);
+    // 获取窗口系统需要的扩展，离屏模式下为空
+    auto windowExtensions = m_window->get_required_extensions();
+    extensions.insert(extensions.end(), windowExtensions.begin(), windowExtensions.end());
 
     // debug需要的扩展
     if (enableValidationLayers)
@@ -696,8 +1098,14 @@ std::vector<const char *> HelloTriangleApplication::getRequiredDeviceExtensions(
 {
     std::vector<const char *> extensions;
 
-    // swapchain需要的扩展
-    extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    // swapchain需要的扩展，离屏模式不需要
+    if (m_window->get_mode() != Window::Mode::Headless)
+    {
+        extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+
+    // 屏障通过BarrierBuilder记录
+    extensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
 
     return extensions;
 }
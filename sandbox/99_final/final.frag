@@ -4,7 +4,15 @@ layout(location = 0) in vec3 fragColor;
 
 layout(location = 0) out vec4 outColor;
 
+// 由管线变体设置，驱动按常量折叠掉不用的分支
+layout(constant_id = 0) const bool GRAYSCALE = false;
+
 void main()
 {
-    outColor = vec4(fragColor, 1.0);
+    vec3 color = fragColor;
+    if (GRAYSCALE)
+    {
+        color = vec3(dot(color, vec3(0.299, 0.587, 0.114)));
+    }
+    outColor = vec4(color, 1.0);
 }
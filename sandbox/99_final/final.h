@@ -7,13 +7,35 @@
 #include <optional>
 #include <filesystem>
 #include <memory>
+#include <chrono>
 
 #include "comet/platform/window/glfw_window.h"
+#include "comet/platform/window/headless_window.h"
 #include "comet/vulkan/instance.h"
 #include "comet/vulkan/physical_device.h"
 #include "comet/vulkan/device.h"
 #include "comet/vulkan/swapchain.h"
+#include "comet/vulkan/headless_swapchain.h"
 #include "comet/vulkan/image_view.h"
+#include "comet/vulkan/barrier.h"
+#include "comet/vulkan/resource_cache.h"
+#include "comet/vulkan/pipeline_cache.h"
+#include "comet/vulkan/shader_reflection.h"
+#include "comet/vulkan/compute_pipeline.h"
+#include "comet/vulkan/descriptor_pool.h"
+#include "comet/rendering/frame_scheduler.h"
+#include "comet/rendering/frame_stats.h"
+#include "comet/rendering/dynamic_resolution.h"
+#include "comet/rendering/upscaler.h"
+#include "comet/rendering/parallel_recorder.h"
+#include "comet/rendering/render_graph.h"
+#include "comet/rendering/static_command_cache.h"
+#include "comet/rendering/indirect_batcher.h"
+#include "comet/rendering/shader_compiler.h"
+#include "comet/rendering/embedded_shaders.h"
+#include "comet/rendering/pipeline_hot_reload.h"
+#include "comet/rendering/pipeline_registry.h"
+#include "comet/core/thread_pool.h"
 
 using namespace comet;
 
@@ -44,32 +66,92 @@ class HelloTriangleApplication
 {
 private:
     std::unique_ptr<Window> m_window;
-    VkSurfaceKHR m_surface;
+    // 渲染线程看到的窗口大小，由Resize消息更新
+    Window::Extent m_windowExtent{};
+    VkSurfaceKHR m_surface{VK_NULL_HANDLE};
     std::unique_ptr<Instance> m_instance;
     std::unique_ptr<Device> m_device;
-    std::unique_ptr<Swapchain> m_swapchain;
-    // 交换链中的图像视图
-    std::vector<VkImageView> m_swapChainImageViews;
-
-    // 渲染通道
-    VkRenderPass m_renderPass{};
-    // 管线布局
-    VkPipelineLayout m_pipelineLayout{};
-    // 图形管线
+    // 窗口交换链或离屏模拟的交换链
+    std::unique_ptr<Presenter> m_swapchain;
+    // 离屏模式下渲染的帧数，0表示不限
+    uint64_t m_headlessFrameLimit{0};
+    // 图像视图、采样器缓存
+    std::unique_ptr<ResourceCache> m_resourceCache;
+    // 交换链中的图像，只作为拉伸的目标
+    std::vector<std::unique_ptr<Image>> m_swapChainImages;
+    std::vector<std::shared_ptr<ImageView>> m_swapChainImageViews;
+    // 场景渲染到离屏目标，再按动态分辨率拉伸到交换链图像
+    std::unique_ptr<Image> m_sceneImage;
+    std::shared_ptr<ImageView> m_sceneImageView;
+    DynamicResolution m_dynamicResolution;
+    // 双线性拉伸加锐化，把场景合成到交换链图像
+    std::unique_ptr<Upscaler> m_upscaler;
+    // 创建当前交换链时请求的分辨率
+    VkExtent2D m_swapChainRequestedExtent{};
+    // 创建当前交换链时的延迟模式，运行时切换后据此重建交换链
+    LatencyMode m_swapChainLatencyMode{};
+
+    // 设置COMET_SHADER_HOT_RELOAD=1时运行时编译着色器，修改后在后台重建管线，否则为空
+    std::unique_ptr<ThreadPool> m_shaderThreadPool;
+    std::unique_ptr<ShaderCompiler> m_shaderCompiler;
+    std::unique_ptr<PipelineHotReload> m_pipelineHotReload;
+    // 磁盘上的管线缓存
+    std::unique_ptr<PipelineCache> m_pipelineCache;
+    // 热重载线程使用的缓存，由m_pipelineCache持有，保存时合并
+    VkPipelineCache m_hotReloadPipelineCache{VK_NULL_HANDLE};
+    // 不热重载时在后台创建管线变体，否则为空
+    std::unique_ptr<ThreadPool> m_pipelineThreadPool;
+    std::unique_ptr<PipelineRegistry> m_pipelineRegistry;
+    // 默认变体是后备，m_grayscale时另一个是灰度变体，否则两者相同
+    PipelineHandle m_defaultPipeline;
+    PipelineHandle m_variantPipeline;
+
+    // 设备支持动态渲染时不使用渲染通道和帧缓冲，COMET_DYNAMIC_RENDERING=0强制使用渲染通道
+    bool m_dynamicRendering{false};
+    // 场景目标的格式，管线按它创建
+    VkFormat m_sceneFormat{VK_FORMAT_UNDEFINED};
+    // 渲染通道，在m_resourceCache中去重，动态渲染时为空
+    std::shared_ptr<RenderPass> m_renderPass;
+    // 由着色器反射生成的管线布局，在m_resourceCache中去重
+    std::shared_ptr<PipelineLayout> m_pipelineLayout;
+    // 图形管线，由m_pipelineHotReload或m_pipelineRegistry持有，每帧开始时更新
     VkPipeline m_graphicsPipeline{};
-
-    // 帧缓冲
-    std::vector<VkFramebuffer> m_swapChainFramebuffers{};
-
-    // 命令池
-    VkCommandPool m_commandPool{};
-    // 命令缓冲
-    VkCommandBuffer m_commandBuffer{};
-
-    // 同步对象
-    VkSemaphore m_imageAvailableSemaphore{};
-    VkSemaphore m_renderFinishedSemaphore{};
-    VkFence m_inFlightFence{};
+    uint32_t m_graphicsPipelineId{0};
+    // 片段着色器的灰度变体，由特化常量选择
+    bool m_grayscale{false};
+
+    // 场景的帧缓冲，动态渲染时为空
+    std::shared_ptr<Framebuffer> m_sceneFramebuffer;
+
+    // 录制次级命令缓冲的工作线程
+    std::unique_ptr<ThreadPool> m_recordThreadPool;
+    std::unique_ptr<ParallelRecorder> m_parallelRecorder;
+    // 设置COMET_STATIC_COMMANDS=1时场景只在输入变化时录制，否则每帧并行录制
+    std::unique_ptr<StaticCommandCache> m_staticCommandCache;
+    // 设置COMET_INDIRECT_DRAWS=1时使用，优先于命令缓存
+    std::unique_ptr<IndirectBatcher> m_indirectBatcher;
+    std::unique_ptr<Buffer> m_indexBuffer;
+
+    // 每帧重新声明场景、拉伸(以及异步计算的图案)等通道，屏障由渲染图生成
+    std::unique_ptr<RenderGraph> m_renderGraph;
+
+    // 每帧的命令缓冲和同步对象
+    std::unique_ptr<FrameScheduler> m_frameScheduler;
+
+    // 设置COMET_ASYNC_COMPUTE=1时在异步计算队列上生成画中画图案，再复制到场景左上角。
+    // 计算队列的每帧命令池也由一个帧调度器管理
+    std::unique_ptr<FrameScheduler> m_asyncComputeScheduler;
+    std::unique_ptr<ComputePipeline> m_overlayPipeline;
+    // 渲染图重新分配临时图像后重建，旧的交给延迟删除队列
+    std::shared_ptr<ImageView> m_overlayView;
+    std::unique_ptr<DescriptorPool> m_overlayDescriptorPool;
+    VkDescriptorSet m_overlayDescriptorSet{VK_NULL_HANDLE};
+    std::chrono::steady_clock::time_point m_overlayStartTime;
+
+    // 帧耗时统计
+    FrameStats m_frameStats;
+    // 当前帧的耗时，drawFrame中填写等待时间
+    FrameTiming m_frameTiming{};
 
 public:
     HelloTriangleApplication();
@@ -85,6 +167,9 @@ private:
 
     void mainLoop();
 
+    // 渲染线程的帧循环
+    void renderLoop();
+
     void cleanup();
 
     std::vector<const char *> getRequiredInstanceExtensions();
@@ -92,8 +177,12 @@ private:
     std::vector<const char *> getRequiredDeviceExtensions();
 
     //--------------------------------------------------
-    // 创建图像视图
-    void createImageViews();
+    // 包装交换链图像
+    void createSwapChainImages();
+
+    //--------------------------------------------------
+    // 创建场景渲染目标及其图像视图
+    void createSceneTarget();
 
     //--------------------------------------------------
     // 创建渲染通道
@@ -103,34 +192,39 @@ private:
     // 创建图形管线
     void createGraphicsPipeline();
 
-    // 读取文件
-    static std::vector<char> readFile(const std::filesystem::path &filename);
+    // 用编译好的着色器创建管线，热重载时在后台线程调用
+    VkPipeline buildGraphicsPipeline(const std::vector<ShaderBinary> &shaders);
 
-    // 创建着色器模块
-    VkShaderModule createShaderModule(const std::vector<char> &code);
+    // 管线的完整状态，grayscale选择片段着色器的变体
+    GraphicsPipelineDesc describeGraphicsPipeline(const std::vector<ShaderBinary> &shaders, bool grayscale);
 
     //--------------------------------------------------
-    // 创建帧缓冲
-    void createFramebuffers();
+    // 创建拉伸管线
+    void createUpscaler();
 
     //--------------------------------------------------
-    // 创建命令池
-    void createCommandPool();
+    // 创建异步计算的队列、命令池和计算管线
+    void createAsyncCompute();
 
     //--------------------------------------------------
-    // 创建命令缓冲
-    void createCommandBuffer();
+    // 创建场景帧缓冲
+    void createFramebuffers();
 
     //--------------------------------------------------
-    // 创建同步对象
-    void createSyncObjects();
+    // 创建帧调度器
+    void createFrameScheduler();
 
     //==================================================
     // 主循环
     //--------------------------------------------------
-    void drawFrame();
+    void drawFrame(FrameContext &frame);
 
-    void recordCommandBuffer(VkCommandBuffer commandBuffer, unsigned int imageIndex);
+    // asyncCommandBuffer不为空时，异步计算通道录制在其中
+    void recordCommandBuffer(FrameContext &frame, CommandBuffer &commandBuffer, CommandBuffer *asyncCommandBuffer, unsigned int imageIndex);
+
+    //--------------------------------------------------
+    // 重建交换链：以旧交换链为oldSwapchain创建新的，旧资源放入设备的延迟删除队列
+    void recreateSwapChain();
 
     //==================================================
 }; // class HelloTriangleApplication
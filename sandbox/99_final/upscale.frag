@@ -0,0 +1,56 @@
+#version 450
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D sceneTexture;
+
+// 与comet::Upscaler中的结构一致
+layout(push_constant) uniform PushConstants
+{
+    // 渲染区域在整个场景图像中的比例
+    vec2 uvScale;
+    // 一个输出像素对应的场景纹理坐标距离
+    vec2 uvStep;
+    // 渲染区域内最后一个像素的中心，避免采样到区域之外
+    vec2 uvMax;
+    // 0只做双线性拉伸，1最强
+    float sharpness;
+} pc;
+
+vec3 fetch(vec2 uv)
+{
+    return texture(sceneTexture, clamp(uv, vec2(0.0), pc.uvMax)).rgb;
+}
+
+// 对比度自适应锐化(RCAS)：在输出分辨率上对双线性结果做十字形5点锐化，
+// 锐化量按邻域的最小/最大值限制，不会产生超出邻域范围的光晕
+void main()
+{
+    vec2 uv = inUV * pc.uvScale;
+
+    vec3 e = fetch(uv);
+    if (pc.sharpness <= 0.0)
+    {
+        outColor = vec4(e, 1.0);
+        return;
+    }
+
+    vec3 b = fetch(uv - vec2(0.0, pc.uvStep.y));
+    vec3 d = fetch(uv - vec2(pc.uvStep.x, 0.0));
+    vec3 f = fetch(uv + vec2(pc.uvStep.x, 0.0));
+    vec3 h = fetch(uv + vec2(0.0, pc.uvStep.y));
+
+    vec3 mn4 = min(min(b, d), min(f, h));
+    vec3 mx4 = max(max(b, d), max(f, h));
+
+    // 不让结果低于0或超过1时允许的最大负权重
+    vec3 hitMin = min(mn4, e) / (4.0 * mx4 + 1.0e-5);
+    vec3 hitMax = (1.0 - max(mx4, e)) / (4.0 * mn4 - 4.0 - 1.0e-5);
+    vec3 lobeRGB = max(-hitMin, hitMax);
+    float lobe = max(-0.1875, min(max(lobeRGB.r, max(lobeRGB.g, lobeRGB.b)), 0.0)) * pc.sharpness;
+
+    vec3 color = (lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0);
+    outColor = vec4(color, 1.0);
+}
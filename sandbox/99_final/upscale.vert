@@ -0,0 +1,10 @@
+#version 450
+
+layout(location = 0) out vec2 outUV;
+
+// 覆盖整个屏幕的三角形，不需要顶点缓冲
+void main()
+{
+    outUV = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(outUV * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,137 @@
+#include "comet/core/file_watcher.h"
+
+#include <stdexcept>
+#include <system_error>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace comet;
+
+namespace
+{
+std::filesystem::path normalize(const std::filesystem::path &path)
+{
+    std::error_code error;
+    auto absolute = std::filesystem::absolute(path, error);
+    return (error ? path : absolute).lexically_normal();
+}
+} // namespace
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher()
+{
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+    {
+        throw std::runtime_error("failed to initialize inotify!");
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+    // 关闭描述符会移除所有监视
+    close(m_fd);
+}
+
+void FileWatcher::watch(const std::filesystem::path &path)
+{
+    auto file = normalize(path);
+    if (!m_files.insert(file).second)
+    {
+        return;
+    }
+
+    auto directory = file.parent_path();
+    for (const auto &[descriptor, watched] : m_directories)
+    {
+        if (watched == directory)
+        {
+            return;
+        }
+    }
+
+    // 只关心写完关闭和重命名覆盖，IN_CREATE时文件内容可能还没写入
+    int descriptor = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0)
+    {
+        throw std::runtime_error("failed to watch directory " + directory.string() + "!");
+    }
+    m_directories[descriptor] = directory;
+}
+
+std::vector<std::filesystem::path> FileWatcher::poll()
+{
+    std::set<std::filesystem::path> changed;
+
+    alignas(inotify_event) char buffer[4096];
+    while (true)
+    {
+        auto length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            // EAGAIN：没有更多事件
+            break;
+        }
+
+        for (char *pointer = buffer; pointer < buffer + length;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(pointer);
+            pointer += sizeof(inotify_event) + event->len;
+
+            auto directory = m_directories.find(event->wd);
+            if (directory == m_directories.end() || event->len == 0)
+            {
+                continue;
+            }
+
+            auto file = directory->second / event->name;
+            if (m_files.count(file))
+            {
+                changed.insert(file);
+            }
+        }
+    }
+
+    return {changed.begin(), changed.end()};
+}
+
+#else
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher() = default;
+
+void FileWatcher::watch(const std::filesystem::path &path)
+{
+    auto file = normalize(path);
+    if (!m_files.insert(file).second)
+    {
+        return;
+    }
+
+    std::error_code error;
+    m_write_times[file] = std::filesystem::last_write_time(file, error);
+}
+
+std::vector<std::filesystem::path> FileWatcher::poll()
+{
+    std::vector<std::filesystem::path> changed;
+    for (auto &[file, write_time] : m_write_times)
+    {
+        std::error_code error;
+        auto current = std::filesystem::last_write_time(file, error);
+        if (!error && current != write_time)
+        {
+            write_time = current;
+            changed.push_back(file);
+        }
+    }
+    return changed;
+}
+
+#endif
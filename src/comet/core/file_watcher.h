@@ -0,0 +1,45 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace comet
+{
+    /// 监视一组文件的修改。Linux上用inotify监视文件所在的目录，
+    /// 编辑器先写临时文件再重命名覆盖时也能收到通知；其他平台比较修改时间
+    class FileWatcher
+    {
+    public:
+        FileWatcher();
+
+        FileWatcher(const FileWatcher &) = delete;
+
+        FileWatcher(FileWatcher &&) = delete;
+
+        ~FileWatcher();
+
+        FileWatcher &operator=(const FileWatcher &) = delete;
+
+        FileWatcher &operator=(FileWatcher &&) = delete;
+
+        /// 重复添加同一个文件没有影响
+        void watch(const std::filesystem::path &path);
+
+        /// 不阻塞，返回上次调用以来被修改的文件(绝对路径)，每个文件只出现一次
+        std::vector<std::filesystem::path> poll();
+
+    private:
+        std::set<std::filesystem::path> m_files;
+
+#ifdef __linux__
+        int m_fd{-1};
+
+        /// inotify监视描述符对应的目录
+        std::map<int, std::filesystem::path> m_directories;
+#else
+        std::map<std::filesystem::path, std::filesystem::file_time_type> m_write_times;
+#endif
+    };
+} // namespace comet
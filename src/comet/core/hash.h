@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace comet
+{
+    /// 与boost::hash_combine相同的组合方式
+    template <typename T>
+    inline void hash_combine(size_t &seed, const T &value)
+    {
+        std::hash<T> hasher;
+        seed ^= hasher(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    /// 64位FNV-1a，不依赖标准库实现，结果跨进程稳定，可以作为磁盘缓存的键
+    inline uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = 0xcbf29ce484222325ull)
+    {
+        auto bytes = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            seed ^= bytes[i];
+            seed *= 0x100000001b3ull;
+        }
+        return seed;
+    }
+
+} // namespace comet
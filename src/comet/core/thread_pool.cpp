@@ -0,0 +1,76 @@
+#include "comet/core/thread_pool.h"
+
+#include <stdexcept>
+
+using namespace comet;
+
+ThreadPool::ThreadPool(uint32_t thread_count)
+{
+    if (thread_count == 0)
+    {
+        throw std::runtime_error("thread pool needs at least one thread!");
+    }
+
+    m_threads.reserve(thread_count);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::worker, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    for (auto &thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+std::future<void> ThreadPool::push(std::function<void(uint32_t)> task)
+{
+    std::packaged_task<void(uint32_t)> packaged{std::move(task)};
+    auto future = packaged.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_tasks.push(std::move(packaged));
+    }
+    m_condition.notify_one();
+
+    return future;
+}
+
+uint32_t ThreadPool::get_thread_count() const
+{
+    return static_cast<uint32_t>(m_threads.size());
+}
+
+void ThreadPool::worker(uint32_t thread_index)
+{
+    while (true)
+    {
+        std::packaged_task<void(uint32_t)> task;
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_condition.wait(lock, [this]
+                             { return m_stop || !m_tasks.empty(); });
+
+            // 停止时仍然把队列中的任务执行完，保证future都能就绪
+            if (m_tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task(thread_index);
+    }
+}
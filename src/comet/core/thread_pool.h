@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace comet
+{
+    /// 固定数量的工作线程，每个线程有稳定的索引，
+    /// 可以用来选择线程独占的资源(例如每帧每线程的命令池)
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(uint32_t thread_count);
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool(ThreadPool &&) = delete;
+
+        /// 执行完已提交的任务后退出
+        ~ThreadPool();
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(ThreadPool &&) = delete;
+
+        /// 提交任务，参数为执行它的工作线程索引[0, thread_count)。
+        /// 任务抛出的异常在future.get()时重新抛出
+        std::future<void> push(std::function<void(uint32_t)> task);
+
+        uint32_t get_thread_count() const;
+
+    private:
+        void worker(uint32_t thread_index);
+
+    private:
+        std::vector<std::thread> m_threads;
+
+        std::queue<std::packaged_task<void(uint32_t)>> m_tasks;
+
+        std::mutex m_mutex;
+
+        std::condition_variable m_condition;
+
+        bool m_stop{false};
+    };
+} // namespace comet
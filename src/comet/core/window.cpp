@@ -9,11 +9,49 @@ Window::Window(const Properties &properties)
 
 Window::Extent Window::resize(const Extent &extent)
 {
-    if (m_properties.resizable)
+    if (m_properties.resizable && (m_properties.extent.width != extent.width || m_properties.extent.height != extent.height))
     {
         m_properties.extent.width = extent.width;
         m_properties.extent.height = extent.height;
+
+        // 先写大小再置标志，渲染线程看到标志时一定能读到这次或更新的大小
+        m_latest_extent.store((static_cast<uint64_t>(extent.width) << 32) | extent.height, std::memory_order_relaxed);
+        m_resized.store(true, std::memory_order_release);
     }
 
     return m_properties.extent;
+}
+
+const Window::Extent &Window::get_extent() const
+{
+    return m_properties.extent;
+}
+
+Window::Mode Window::get_mode() const
+{
+    return m_properties.mode;
+}
+
+bool Window::poll_event(Event &event)
+{
+    if (m_close_requested.exchange(false, std::memory_order_acquire))
+    {
+        event = {Event::Type::Close, {}};
+        return true;
+    }
+
+    // 多次变化合并为一条，只取最新的大小
+    if (m_resized.exchange(false, std::memory_order_acquire))
+    {
+        auto extent = m_latest_extent.load(std::memory_order_relaxed);
+        event = {Event::Type::Resize, {static_cast<uint32_t>(extent >> 32), static_cast<uint32_t>(extent)}};
+        return true;
+    }
+
+    return false;
+}
+
+void Window::request_close()
+{
+    m_close_requested.store(true, std::memory_order_release);
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -34,6 +36,22 @@ namespace comet
             Default
         };
 
+        /// 事件线程发给渲染线程的消息。消息不排队：关闭是一个标志，大小变化只保留最新值，
+        /// 渲染线程处理得再慢也不会丢失
+        struct Event
+        {
+            enum class Type
+            {
+                Resize,
+                Close
+            };
+
+            Type type;
+
+            /// Resize时的新帧缓冲大小
+            Extent extent;
+        };
+
         struct Properties
         {
             std::string title = "";
@@ -52,16 +70,41 @@ namespace comet
 
         virtual void process_events() = 0;
 
+        /// 阻塞直到有新事件，窗口最小化时使用，避免空转
+        virtual void wait_events() = 0;
+
+        /// 请求关闭窗口，可以在任意线程调用
         virtual void close() = 0;
 
         virtual std::vector<const char *> get_required_extensions() const = 0;
 
         virtual VkSurfaceKHR create_surface(VkInstance instance, VkPhysicalDevice physical_device) = 0;
 
+        /// 只在事件线程调用，大小变化时更新发给渲染线程的最新大小
         Extent resize(const Extent &extent);
 
+        /// 当前帧缓冲大小，最小化时宽高为0。只在事件线程读取，渲染线程应使用Resize消息
+        const Extent &get_extent() const;
+
+        Mode get_mode() const;
+
+        /// 渲染线程取出一条消息，没有消息时返回false。关闭请求优先，每个请求只返回一次
+        bool poll_event(Event &event);
+
+    protected:
+        /// 事件线程请求渲染线程退出
+        void request_close();
+
     private:
         Properties m_properties;
 
+        std::atomic<bool> m_close_requested{false};
+
+        /// 有尚未取走的大小变化
+        std::atomic<bool> m_resized{false};
+
+        /// 最新的帧缓冲大小，高32位为宽，低32位为高
+        std::atomic<uint64_t> m_latest_extent{0};
+
     }; // class Window
 } // namespace comet
\ No newline at end of file
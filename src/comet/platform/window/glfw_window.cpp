@@ -5,6 +5,22 @@
 
 using namespace comet;
 
+namespace
+{
+void framebuffer_size_callback(GLFWwindow *handle, int width, int height)
+{
+    // 最小化时宽高为0，交由使用者暂停渲染
+    auto window = static_cast<GlfwWindow *>(glfwGetWindowUserPointer(handle));
+    window->resize({static_cast<uint32_t>(width), static_cast<uint32_t>(height)});
+}
+
+void window_close_callback(GLFWwindow *handle)
+{
+    auto window = static_cast<GlfwWindow *>(glfwGetWindowUserPointer(handle));
+    window->on_close();
+}
+} // namespace
+
 GlfwWindow::GlfwWindow(const Window::Properties &properties)
     : Window(properties)
 {
@@ -19,6 +35,19 @@ GlfwWindow::GlfwWindow(const Window::Properties &properties)
     glfwWindowHint(GLFW_RESIZABLE, properties.resizable);
 
     m_handle = glfwCreateWindow(properties.extent.width, properties.extent.height, properties.title.c_str(), nullptr, nullptr);
+    if (!m_handle)
+    {
+        throw std::runtime_error("Failed to create GLFW window");
+    }
+
+    // 高DPI下帧缓冲大小与窗口大小不同，以帧缓冲大小为准
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(m_handle, &width, &height);
+    resize({static_cast<uint32_t>(width), static_cast<uint32_t>(height)});
+
+    glfwSetWindowUserPointer(m_handle, this);
+    glfwSetFramebufferSizeCallback(m_handle, framebuffer_size_callback);
+    glfwSetWindowCloseCallback(m_handle, window_close_callback);
 }
 
 GlfwWindow::~GlfwWindow()
@@ -38,9 +67,21 @@ void GlfwWindow::process_events()
     glfwPollEvents();
 }
 
+void GlfwWindow::wait_events()
+{
+    glfwWaitEvents();
+}
+
 void GlfwWindow::close()
 {
+    // 可能在渲染线程调用，唤醒阻塞在wait_events中的事件线程
     glfwSetWindowShouldClose(m_handle, GLFW_TRUE);
+    glfwPostEmptyEvent();
+}
+
+void GlfwWindow::on_close()
+{
+    request_close();
 }
 
 std::vector<const char *> GlfwWindow::get_required_extensions() const
@@ -21,12 +21,17 @@ namespace comet
 
         void process_events() override;
 
+        void wait_events() override;
+
         void close() override;
 
         std::vector<const char *> get_required_extensions() const override;
 
         VkSurfaceKHR create_surface(VkInstance instance, VkPhysicalDevice physical_device) override;
 
+        /// 用户关闭窗口时在事件线程调用，通知渲染线程
+        void on_close();
+
     private:
         GLFWwindow *m_handle{nullptr};
     };
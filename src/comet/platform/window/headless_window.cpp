@@ -0,0 +1,44 @@
+#include "comet/platform/window/headless_window.h"
+
+using namespace comet;
+
+HeadlessWindow::HeadlessWindow(const Window::Properties &properties)
+    : Window(properties)
+{
+}
+
+bool HeadlessWindow::should_close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_closed;
+}
+
+void HeadlessWindow::process_events()
+{
+}
+
+void HeadlessWindow::wait_events()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]
+                     { return m_closed; });
+}
+
+void HeadlessWindow::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_condition.notify_all();
+}
+
+std::vector<const char *> HeadlessWindow::get_required_extensions() const
+{
+    return {};
+}
+
+VkSurfaceKHR HeadlessWindow::create_surface(VkInstance instance, VkPhysicalDevice physical_device)
+{
+    return VK_NULL_HANDLE;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+#include "volk.h"
+
+#include "comet/core/window.h"
+
+namespace comet
+{
+    /// 没有窗口系统的"窗口"：不创建表面，由使用者调用close()结束。
+    /// wait_events阻塞到close()被调用，事件线程不会空转
+    class HeadlessWindow : public Window
+    {
+    public:
+        HeadlessWindow(const Window::Properties &properties);
+
+        ~HeadlessWindow() override = default;
+
+        bool should_close() override;
+
+        void process_events() override;
+
+        void wait_events() override;
+
+        void close() override;
+
+        std::vector<const char *> get_required_extensions() const override;
+
+        VkSurfaceKHR create_surface(VkInstance instance, VkPhysicalDevice physical_device) override;
+
+    private:
+        std::mutex m_mutex;
+
+        std::condition_variable m_condition;
+
+        bool m_closed{false};
+    };
+
+} // namespace comet
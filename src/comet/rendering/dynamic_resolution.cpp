@@ -0,0 +1,81 @@
+#include "comet/rendering/dynamic_resolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace comet;
+
+namespace
+{
+VkExtent2D scale_extent(const VkExtent2D &extent, float scale)
+{
+    return {std::max(1u, static_cast<uint32_t>(std::lround(extent.width * scale))),
+            std::max(1u, static_cast<uint32_t>(std::lround(extent.height * scale)))};
+}
+} // namespace
+
+DynamicResolution::DynamicResolution()
+    : DynamicResolution(Settings{})
+{
+}
+
+DynamicResolution::DynamicResolution(const Settings &settings)
+{
+    set_settings(settings);
+}
+
+float DynamicResolution::update(double gpu_time)
+{
+    if (gpu_time <= 0.0)
+    {
+        return m_scale;
+    }
+
+    m_filtered_gpu_time = m_filtered_gpu_time > 0.0 ? m_filtered_gpu_time + m_settings.smoothing * (gpu_time - m_filtered_gpu_time) : gpu_time;
+
+    double error = m_filtered_gpu_time / m_settings.target_gpu_time;
+    if (std::abs(error - 1.0) <= m_settings.tolerance)
+    {
+        return m_scale;
+    }
+
+    // 耗时大致与像素数成正比，即与比例的平方成正比
+    auto desired = static_cast<float>(m_scale / std::sqrt(error));
+    m_scale += std::clamp(desired - m_scale, -m_settings.max_step, m_settings.max_step);
+    m_scale = std::clamp(m_scale, m_settings.min_scale, m_settings.max_scale);
+
+    return m_scale;
+}
+
+float DynamicResolution::get_scale() const
+{
+    return m_scale;
+}
+
+void DynamicResolution::set_settings(const Settings &settings)
+{
+    if (settings.min_scale <= 0.0f || settings.min_scale > settings.max_scale || settings.target_gpu_time <= 0.0)
+    {
+        throw std::runtime_error("invalid dynamic resolution settings!");
+    }
+
+    m_settings = settings;
+    m_scale = settings.max_scale;
+    m_filtered_gpu_time = 0.0;
+}
+
+const DynamicResolution::Settings &DynamicResolution::get_settings() const
+{
+    return m_settings;
+}
+
+VkExtent2D DynamicResolution::get_render_extent(const VkExtent2D &output_extent) const
+{
+    return scale_extent(output_extent, m_scale);
+}
+
+VkExtent2D DynamicResolution::get_max_extent(const VkExtent2D &output_extent) const
+{
+    return scale_extent(output_extent, m_settings.max_scale);
+}
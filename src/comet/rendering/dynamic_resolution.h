@@ -0,0 +1,59 @@
+#pragma once
+
+#include "volk.h"
+
+namespace comet
+{
+    /// 根据GPU耗时调整场景的渲染分辨率，由Upscaler拉伸到输出图像。
+    /// 离屏目标按最大比例分配一次，缩放只改变使用的区域，不需要重新分配
+    class DynamicResolution
+    {
+    public:
+        struct Settings
+        {
+            /// 目标GPU耗时(毫秒)
+            double target_gpu_time{16.6};
+
+            /// 渲染分辨率相对输出分辨率的比例范围
+            float min_scale{0.5f};
+
+            float max_scale{1.0f};
+
+            /// 每帧比例最多变化多少，GPU耗时有几帧延迟，步长过大会振荡
+            float max_step{0.05f};
+
+            /// GPU耗时的指数平滑系数
+            double smoothing{0.1};
+
+            /// 偏离目标在这个比例以内时不调整
+            double tolerance{0.05};
+        };
+
+    public:
+        DynamicResolution();
+
+        explicit DynamicResolution(const Settings &settings);
+
+        /// 输入最近一帧的GPU耗时，返回新的比例；gpu_time不大于0时忽略
+        float update(double gpu_time);
+
+        float get_scale() const;
+
+        void set_settings(const Settings &settings);
+
+        const Settings &get_settings() const;
+
+        /// 当前比例下的渲染分辨率
+        VkExtent2D get_render_extent(const VkExtent2D &output_extent) const;
+
+        /// 最大比例下的渲染分辨率，离屏目标按这个大小分配
+        VkExtent2D get_max_extent(const VkExtent2D &output_extent) const;
+
+    private:
+        Settings m_settings;
+
+        float m_scale;
+
+        double m_filtered_gpu_time{0.0};
+    };
+} // namespace comet
@@ -0,0 +1,74 @@
+#include "comet/rendering/embedded_shaders.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace comet;
+
+namespace
+{
+struct EmbeddedShader
+{
+    const uint32_t *code;
+
+    size_t word_count;
+};
+
+/// 函数内的静态变量，不受各编译单元静态初始化顺序的影响
+std::unordered_map<std::string, EmbeddedShader> &get_shaders()
+{
+    static std::unordered_map<std::string, EmbeddedShader> shaders;
+    return shaders;
+}
+
+std::mutex &get_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+} // namespace
+
+void EmbeddedShaders::add(const std::string &name, const uint32_t *code, size_t word_count)
+{
+    std::lock_guard<std::mutex> lock(get_mutex());
+    get_shaders().emplace(name, EmbeddedShader{code, word_count});
+}
+
+bool EmbeddedShaders::contains(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(get_mutex());
+    return get_shaders().count(name) != 0;
+}
+
+ShaderBinary EmbeddedShaders::get(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(get_mutex());
+    auto found = get_shaders().find(name);
+    if (found == get_shaders().end())
+    {
+        throw std::runtime_error("embedded shader " + name + " not found!");
+    }
+
+    ShaderBinary binary{};
+    binary.spirv.assign(found->second.code, found->second.code + found->second.word_count);
+    return binary;
+}
+
+std::vector<std::string> EmbeddedShaders::get_names()
+{
+    std::lock_guard<std::mutex> lock(get_mutex());
+    std::vector<std::string> names;
+    for (const auto &entry : get_shaders())
+    {
+        names.push_back(entry.first);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+EmbeddedShaderRegistration::EmbeddedShaderRegistration(const char *name, const uint32_t *code, size_t word_count)
+{
+    EmbeddedShaders::add(name, code, word_count);
+}
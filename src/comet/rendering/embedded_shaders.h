@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "comet/rendering/shader_compiler.h"
+
+namespace comet
+{
+    /// 构建时编译并链接进可执行文件的SPIR-V，按文件名(例如final.vert)查找，运行时不需要读文件。
+    /// 数据由CMake的add_embedded_shaders生成的源文件在静态初始化时注册
+    class EmbeddedShaders
+    {
+    public:
+        /// code必须在程序运行期间一直有效，同名的着色器只保留第一个
+        static void add(const std::string &name, const uint32_t *code, size_t word_count);
+
+        static bool contains(const std::string &name);
+
+        /// 不存在时抛出异常，返回的dependencies为空
+        static ShaderBinary get(const std::string &name);
+
+        static std::vector<std::string> get_names();
+    };
+
+    /// 在命名空间作用域定义这个类型的对象来注册着色器
+    struct EmbeddedShaderRegistration
+    {
+        EmbeddedShaderRegistration(const char *name, const uint32_t *code, size_t word_count);
+    };
+} // namespace comet
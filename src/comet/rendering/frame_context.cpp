@@ -0,0 +1,153 @@
+#include "comet/rendering/frame_context.h"
+
+#include <stdexcept>
+
+using namespace comet;
+
+FrameContext::FrameContext(Device &device, Queue &queue, uint32_t thread_count)
+    : m_device{device}, m_queue{queue}
+{
+    uint32_t queue_family_index = m_queue.get_family_index();
+    if (thread_count == 0)
+    {
+        throw std::runtime_error("frame context needs at least one command pool!");
+    }
+
+    // 每个线程每帧一个命令池，整体重置比逐个重置命令缓冲更便宜
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        m_command_pools.push_back(std::make_unique<CommandPool>(m_device, queue_family_index, i));
+    }
+
+    // 交换链的获取和呈现只接受二值信号量，帧完成由队列的时间线信号量表示
+    VkSemaphoreCreateInfo semaphore_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+
+    if (vkCreateSemaphore(m_device.get_handle(), &semaphore_info, nullptr, &m_image_available_semaphore) != VK_SUCCESS ||
+        vkCreateSemaphore(m_device.get_handle(), &semaphore_info, nullptr, &m_render_finished_semaphore) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create synchronization objects for a frame!");
+    }
+
+    // 队列族的timestampValidBits为0时不支持时间戳
+    const auto &physical_device = m_device.get_physical_device();
+    uint32_t valid_bits = physical_device.get_queue_family_properties()[queue_family_index].timestampValidBits;
+    if (valid_bits > 0)
+    {
+        VkQueryPoolCreateInfo query_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+        query_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        query_info.queryCount = 2;
+        if (vkCreateQueryPool(m_device.get_handle(), &query_info, nullptr, &m_query_pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create frame timestamp query pool!");
+        }
+
+        m_timestamp_period = physical_device.get_properties().limits.timestampPeriod;
+        m_timestamp_mask = valid_bits >= 64 ? UINT64_MAX : (uint64_t{1} << valid_bits) - 1;
+    }
+}
+
+FrameContext::~FrameContext()
+{
+    if (m_query_pool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(m_device.get_handle(), m_query_pool, nullptr);
+    }
+    vkDestroySemaphore(m_device.get_handle(), m_render_finished_semaphore, nullptr);
+    vkDestroySemaphore(m_device.get_handle(), m_image_available_semaphore, nullptr);
+}
+
+void FrameContext::wait() const
+{
+    // 尚未提交过时值为0，直接返回
+    m_queue.wait(m_submitted_value);
+}
+
+void FrameContext::reset()
+{
+    for (auto &command_pool : m_command_pools)
+    {
+        command_pool->reset();
+    }
+}
+
+CommandBuffer &FrameContext::request_command_buffer(uint32_t thread_index, VkCommandBufferLevel level)
+{
+    if (thread_index >= m_command_pools.size())
+    {
+        throw std::runtime_error("thread index out of range of frame command pools!");
+    }
+
+    return m_command_pools[thread_index]->request_command_buffer(level);
+}
+
+uint32_t FrameContext::get_thread_count() const
+{
+    return static_cast<uint32_t>(m_command_pools.size());
+}
+
+void FrameContext::begin_timer(VkCommandBuffer command_buffer)
+{
+    if (m_query_pool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    vkCmdResetQueryPool(command_buffer, m_query_pool, 0, 2);
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_query_pool, 0);
+}
+
+void FrameContext::end_timer(VkCommandBuffer command_buffer)
+{
+    if (m_query_pool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_query_pool, 1);
+    m_timer_recorded = true;
+}
+
+double FrameContext::get_gpu_time() const
+{
+    if (!m_timer_recorded)
+    {
+        return 0.0;
+    }
+
+    // 已经等待过这一帧的提交，结果一定可用，不需要WAIT
+    uint64_t timestamps[2]{};
+    if (vkGetQueryPoolResults(m_device.get_handle(), m_query_pool, 0, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+    {
+        return 0.0;
+    }
+
+    uint64_t ticks = (timestamps[1] - timestamps[0]) & m_timestamp_mask;
+    return ticks * static_cast<double>(m_timestamp_period) / 1e6;
+}
+
+VkSemaphore FrameContext::get_image_available_semaphore() const
+{
+    return m_image_available_semaphore;
+}
+
+VkSemaphore FrameContext::get_render_finished_semaphore() const
+{
+    return m_render_finished_semaphore;
+}
+
+
+uint64_t FrameContext::get_frame_number() const
+{
+    return m_frame_number;
+}
+
+uint64_t FrameContext::get_submitted_value() const
+{
+    return m_submitted_value;
+}
+
+void FrameContext::set_submitted(uint64_t frame_number, uint64_t submitted_value)
+{
+    m_frame_number = frame_number;
+    m_submitted_value = submitted_value;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/device.h"
+#include "comet/vulkan/command_pool.h"
+#include "comet/vulkan/queue.h"
+
+namespace comet
+{
+    /// 一帧独占的资源：每个录制线程一个命令池、交换链用的二值信号量，
+    /// 以及最近一次提交的帧号和队列时间线上的值
+    class FrameContext
+    {
+    public:
+        FrameContext(Device &device, Queue &queue, uint32_t thread_count = 1);
+
+        FrameContext(const FrameContext &) = delete;
+
+        FrameContext(FrameContext &&) = delete;
+
+        ~FrameContext();
+
+        FrameContext &operator=(const FrameContext &) = delete;
+
+        FrameContext &operator=(FrameContext &&) = delete;
+
+        /// 等待这一帧上次提交的命令执行完毕
+        void wait() const;
+
+        /// 确定要提交时调用：重置所有线程的命令池
+        void reset();
+
+        /// 从thread_index对应的命令池请求命令缓冲，每个线程只能使用自己的索引
+        CommandBuffer &request_command_buffer(uint32_t thread_index = 0, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+        uint32_t get_thread_count() const;
+
+        /// 在命令缓冲开头/结尾写入时间戳，队列不支持时间戳时什么也不做
+        void begin_timer(VkCommandBuffer command_buffer);
+
+        void end_timer(VkCommandBuffer command_buffer);
+
+        /// 上次提交的GPU耗时(毫秒)，需在wait()之后、下次begin_timer()之前读取，没有数据时返回0
+        double get_gpu_time() const;
+
+        VkSemaphore get_image_available_semaphore() const;
+
+        VkSemaphore get_render_finished_semaphore() const;
+
+        uint64_t get_frame_number() const;
+
+        /// 上次提交在队列时间线上的值，尚未提交过时为0
+        uint64_t get_submitted_value() const;
+
+        /// 记录这组资源的一次提交
+        void set_submitted(uint64_t frame_number, uint64_t submitted_value);
+
+    private:
+        Device &m_device;
+
+        Queue &m_queue;
+
+        /// 按线程索引排列，线程之间不需要加锁
+        std::vector<std::unique_ptr<CommandPool>> m_command_pools;
+
+        VkSemaphore m_image_available_semaphore{VK_NULL_HANDLE};
+
+        VkSemaphore m_render_finished_semaphore{VK_NULL_HANDLE};
+
+        /// 两个时间戳：帧开始、帧结束
+        VkQueryPool m_query_pool{VK_NULL_HANDLE};
+
+        /// 每个时间戳单位对应的纳秒数
+        float m_timestamp_period{0.0f};
+
+        uint64_t m_timestamp_mask{0};
+
+        bool m_timer_recorded{false};
+
+        /// 使用这组资源提交的最后一帧，尚未提交过时为UINT64_MAX
+        uint64_t m_frame_number{UINT64_MAX};
+
+        uint64_t m_submitted_value{0};
+    };
+} // namespace comet
@@ -0,0 +1,148 @@
+#include "comet/rendering/frame_scheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace comet;
+
+FrameScheduler::FrameScheduler(Device &device, Queue &queue, uint32_t frames_in_flight, LatencyMode latency_mode,
+                               uint32_t thread_count)
+    : m_device{device},
+      m_queue{queue},
+      m_frames_in_flight{frames_in_flight},
+      m_latency_mode{latency_mode},
+      m_thread_count{thread_count}
+{
+    if (frames_in_flight == 0)
+    {
+        throw std::runtime_error("frames in flight must be at least 1!");
+    }
+
+    create_contexts();
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    wait_all();
+}
+
+FrameContext &FrameScheduler::wait_for_frame()
+{
+    auto &context = *m_contexts[m_current];
+
+    if (m_latency_mode == LatencyMode::LowLatency)
+    {
+        // 等待所有已提交的帧，之后采样的输入会在下一次呈现中体现
+        wait_all();
+    }
+    else
+    {
+        // 只等待N帧之前使用同一组资源的那一帧
+        context.wait();
+        mark_completed(context);
+    }
+
+    return context;
+}
+
+void FrameScheduler::end_frame(uint64_t submitted_value)
+{
+    m_contexts[m_current]->set_submitted(m_submitted_frames, submitted_value);
+    m_submitted_frames++;
+    m_current = (m_current + 1) % m_frames_in_flight;
+}
+
+void FrameScheduler::wait_all()
+{
+    // 队列按顺序完成，只需要等待最后提交的一帧
+    uint64_t last_value = 0;
+    for (const auto &context : m_contexts)
+    {
+        last_value = std::max(last_value, context->get_submitted_value());
+    }
+    m_queue.wait(last_value);
+
+    m_completed_frames = m_submitted_frames;
+}
+
+void FrameScheduler::set_frames_in_flight(uint32_t frames_in_flight)
+{
+    if (frames_in_flight == 0)
+    {
+        throw std::runtime_error("frames in flight must be at least 1!");
+    }
+
+    if (frames_in_flight == m_frames_in_flight)
+    {
+        return;
+    }
+
+    // 只等待本调度器提交的帧，不需要整个设备空闲
+    wait_all();
+
+    m_frames_in_flight = frames_in_flight;
+    create_contexts();
+}
+
+uint32_t FrameScheduler::get_frames_in_flight() const
+{
+    return m_frames_in_flight;
+}
+
+uint32_t FrameScheduler::get_thread_count() const
+{
+    return m_thread_count;
+}
+
+void FrameScheduler::set_latency_mode(LatencyMode latency_mode)
+{
+    m_latency_mode = latency_mode;
+}
+
+LatencyMode FrameScheduler::get_latency_mode() const
+{
+    return m_latency_mode;
+}
+
+std::vector<VkPresentModeKHR> FrameScheduler::get_present_mode_priority_list() const
+{
+    if (m_latency_mode == LatencyMode::LowLatency)
+    {
+        return {VK_PRESENT_MODE_FIFO_KHR};
+    }
+
+    return {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_KHR};
+}
+
+Queue &FrameScheduler::get_queue()
+{
+    return m_queue;
+}
+
+uint64_t FrameScheduler::get_submitted_frame_count() const
+{
+    return m_submitted_frames;
+}
+
+uint64_t FrameScheduler::get_completed_frame_count() const
+{
+    return m_completed_frames;
+}
+
+void FrameScheduler::create_contexts()
+{
+    m_contexts.clear();
+    for (uint32_t i = 0; i < m_frames_in_flight; ++i)
+    {
+        m_contexts.push_back(std::make_unique<FrameContext>(m_device, m_queue, m_thread_count));
+    }
+    m_current = 0;
+}
+
+void FrameScheduler::mark_completed(const FrameContext &context)
+{
+    if (context.get_frame_number() != UINT64_MAX)
+    {
+        m_completed_frames = std::max(m_completed_frames, context.get_frame_number() + 1);
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/rendering/frame_context.h"
+#include "comet/vulkan/device.h"
+#include "comet/vulkan/queue.h"
+
+namespace comet
+{
+    enum class LatencyMode
+    {
+        /// 采样输入之前等待GPU完成所有帧，输入到显示的延迟最小
+        LowLatency,
+        /// 只等待N帧之前的那一帧，CPU和GPU深度流水，配合mailbox/immediate呈现
+        Throughput
+    };
+
+    /// 管理N个轮转的FrameContext，帧数和延迟模式都可以在运行时切换
+    class FrameScheduler
+    {
+    public:
+        /// thread_count为录制命令的线程数，每帧每个线程一个命令池
+        /// 帧在queue上提交，完成情况通过队列的时间线信号量判断
+        FrameScheduler(Device &device, Queue &queue, uint32_t frames_in_flight = 2, LatencyMode latency_mode = LatencyMode::Throughput,
+                       uint32_t thread_count = 1);
+
+        FrameScheduler(const FrameScheduler &) = delete;
+
+        FrameScheduler(FrameScheduler &&) = delete;
+
+        ~FrameScheduler();
+
+        FrameScheduler &operator=(const FrameScheduler &) = delete;
+
+        FrameScheduler &operator=(FrameScheduler &&) = delete;
+
+        /// 按当前延迟模式等待，返回下一帧可用的FrameContext。
+        /// 低延迟模式下应在处理输入之前调用
+        FrameContext &wait_for_frame();
+
+        /// 当前帧已经提交，submitted_value为Queue::submit返回的值
+        void end_frame(uint64_t submitted_value);
+
+        /// 等待所有帧完成，用于销毁资源之前
+        void wait_all();
+
+        /// 会等待所有帧完成后重建FrameContext
+        void set_frames_in_flight(uint32_t frames_in_flight);
+
+        uint32_t get_frames_in_flight() const;
+
+        uint32_t get_thread_count() const;
+
+        void set_latency_mode(LatencyMode latency_mode);
+
+        LatencyMode get_latency_mode() const;
+
+        /// 当前延迟模式希望使用的呈现模式，按优先级排列
+        std::vector<VkPresentModeKHR> get_present_mode_priority_list() const;
+
+        Queue &get_queue();
+
+        uint64_t get_submitted_frame_count() const;
+
+        /// 已知GPU执行完毕的帧数，队列按顺序执行，之前的帧也都已完成
+        uint64_t get_completed_frame_count() const;
+
+    private:
+        void create_contexts();
+
+        /// 等待后更新已完成帧数
+        void mark_completed(const FrameContext &context);
+
+    private:
+        Device &m_device;
+
+        Queue &m_queue;
+
+        uint32_t m_frames_in_flight;
+
+        LatencyMode m_latency_mode;
+
+        uint32_t m_thread_count;
+
+        std::vector<std::unique_ptr<FrameContext>> m_contexts;
+
+        uint32_t m_current{0};
+
+        uint64_t m_submitted_frames{0};
+
+        uint64_t m_completed_frames{0};
+    };
+} // namespace comet
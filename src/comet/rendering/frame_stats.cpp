@@ -0,0 +1,171 @@
+#include "comet/rendering/frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+using namespace comet;
+
+namespace
+{
+FramePercentiles compute_percentiles(std::vector<double> &values)
+{
+    FramePercentiles result{};
+    if (values.empty())
+    {
+        return result;
+    }
+
+    std::sort(values.begin(), values.end());
+
+    // nearest-rank
+    auto at = [&](double percentile)
+    {
+        auto rank = static_cast<size_t>(std::ceil(percentile * values.size()));
+        return values[std::min(std::max(rank, size_t{1}), values.size()) - 1];
+    };
+
+    result.p50 = at(0.50);
+    result.p95 = at(0.95);
+    result.p99 = at(0.99);
+    result.max = values.back();
+    return result;
+}
+} // namespace
+
+FrameStats::FrameStats(size_t capacity, double hitch_factor)
+    : m_slots(capacity), m_hitch_factor{hitch_factor}
+{
+    if (capacity == 0)
+    {
+        throw std::runtime_error("frame stats capacity must be at least 1!");
+    }
+}
+
+void FrameStats::record(const FrameTiming &timing)
+{
+    uint64_t frame = m_frame_count.load(std::memory_order_relaxed);
+    auto &slot = m_slots[frame % m_slots.size()];
+
+    // 写入期间序号为奇数，读者会丢弃这个槽位
+    slot.sequence.store(2 * frame + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.cpu_time.store(timing.cpu_time, std::memory_order_relaxed);
+    slot.gpu_time.store(timing.gpu_time, std::memory_order_relaxed);
+    slot.acquire_wait_time.store(timing.acquire_wait_time, std::memory_order_relaxed);
+    slot.present_wait_time.store(timing.present_wait_time, std::memory_order_relaxed);
+
+    slot.sequence.store(2 * frame + 2, std::memory_order_release);
+    m_frame_count.store(frame + 1, std::memory_order_release);
+
+    if (m_report_interval.count() <= 0.0)
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (m_last_report == std::chrono::steady_clock::time_point{})
+    {
+        m_last_report = now;
+        m_last_report_frame = frame + 1;
+    }
+    else if (now - m_last_report >= m_report_interval)
+    {
+        log_summary(frame + 1 - m_last_report_frame);
+        m_last_report = now;
+        m_last_report_frame = frame + 1;
+    }
+}
+
+FrameStatsSummary FrameStats::summarize(size_t window) const
+{
+    uint64_t frame_count = m_frame_count.load(std::memory_order_acquire);
+    auto count = static_cast<size_t>(std::min<uint64_t>({window, frame_count, m_slots.size()}));
+
+    std::vector<double> cpu_times, gpu_times, acquire_wait_times, present_wait_times;
+    cpu_times.reserve(count);
+    gpu_times.reserve(count);
+    acquire_wait_times.reserve(count);
+    present_wait_times.reserve(count);
+
+    for (uint64_t frame = frame_count - count; frame < frame_count; ++frame)
+    {
+        const auto &slot = m_slots[frame % m_slots.size()];
+
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * frame + 2)
+        {
+            // 已被写入线程覆盖
+            continue;
+        }
+
+        double cpu_time = slot.cpu_time.load(std::memory_order_relaxed);
+        double gpu_time = slot.gpu_time.load(std::memory_order_relaxed);
+        double acquire_wait_time = slot.acquire_wait_time.load(std::memory_order_relaxed);
+        double present_wait_time = slot.present_wait_time.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            continue;
+        }
+
+        cpu_times.push_back(cpu_time);
+        gpu_times.push_back(gpu_time);
+        acquire_wait_times.push_back(acquire_wait_time);
+        present_wait_times.push_back(present_wait_time);
+    }
+
+    FrameStatsSummary summary{};
+    summary.frame_count = cpu_times.size();
+
+    // 计算百分位会排序，先按原始顺序统计卡顿
+    auto sorted_cpu_times = cpu_times;
+    summary.cpu_time = compute_percentiles(sorted_cpu_times);
+    for (auto cpu_time : cpu_times)
+    {
+        if (cpu_time > m_hitch_factor * summary.cpu_time.p50)
+        {
+            summary.hitch_count++;
+        }
+    }
+
+    summary.gpu_time = compute_percentiles(gpu_times);
+    summary.acquire_wait_time = compute_percentiles(acquire_wait_times);
+    summary.present_wait_time = compute_percentiles(present_wait_times);
+
+    return summary;
+}
+
+void FrameStats::set_report_interval(double interval)
+{
+    m_report_interval = std::chrono::duration<double>(interval);
+    m_last_report = {};
+}
+
+void FrameStats::log_summary(size_t window) const
+{
+    auto summary = summarize(window);
+    if (summary.frame_count == 0)
+    {
+        return;
+    }
+
+    spdlog::info("frames: {}, hitches: {}", summary.frame_count, summary.hitch_count);
+    spdlog::info("  cpu     p50 {:.2f} p95 {:.2f} p99 {:.2f} max {:.2f} ms",
+                 summary.cpu_time.p50, summary.cpu_time.p95, summary.cpu_time.p99, summary.cpu_time.max);
+    spdlog::info("  gpu     p50 {:.2f} p95 {:.2f} p99 {:.2f} max {:.2f} ms",
+                 summary.gpu_time.p50, summary.gpu_time.p95, summary.gpu_time.p99, summary.gpu_time.max);
+    spdlog::info("  acquire p50 {:.2f} p95 {:.2f} p99 {:.2f} max {:.2f} ms",
+                 summary.acquire_wait_time.p50, summary.acquire_wait_time.p95, summary.acquire_wait_time.p99, summary.acquire_wait_time.max);
+    spdlog::info("  present p50 {:.2f} p95 {:.2f} p99 {:.2f} max {:.2f} ms",
+                 summary.present_wait_time.p50, summary.present_wait_time.p95, summary.present_wait_time.p99, summary.present_wait_time.max);
+}
+
+uint64_t FrameStats::get_frame_count() const
+{
+    return m_frame_count.load(std::memory_order_acquire);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace comet
+{
+    /// 一帧的各项耗时，单位毫秒
+    struct FrameTiming
+    {
+        /// 整帧CPU耗时
+        double cpu_time;
+
+        /// 最近完成的一帧的GPU耗时，没有数据时为0
+        double gpu_time;
+
+        /// 阻塞在vkAcquireNextImageKHR上的时间
+        double acquire_wait_time;
+
+        /// 阻塞在vkQueuePresentKHR上的时间
+        double present_wait_time;
+    };
+
+    struct FramePercentiles
+    {
+        double p50;
+
+        double p95;
+
+        double p99;
+
+        double max;
+    };
+
+    struct FrameStatsSummary
+    {
+        size_t frame_count;
+
+        FramePercentiles cpu_time;
+
+        FramePercentiles gpu_time;
+
+        FramePercentiles acquire_wait_time;
+
+        FramePercentiles present_wait_time;
+
+        /// CPU耗时超过中位数hitch_factor倍的帧数
+        uint32_t hitch_count;
+    };
+
+    /// 帧耗时统计：帧循环单线程写入无锁环形缓冲，其他线程可以随时读取最近的窗口
+    class FrameStats
+    {
+    public:
+        explicit FrameStats(size_t capacity = 1024, double hitch_factor = 2.0);
+
+        FrameStats(const FrameStats &) = delete;
+
+        FrameStats(FrameStats &&) = delete;
+
+        ~FrameStats() = default;
+
+        FrameStats &operator=(const FrameStats &) = delete;
+
+        FrameStats &operator=(FrameStats &&) = delete;
+
+        /// 只能由一个线程调用；到达报告间隔时输出一次日志
+        void record(const FrameTiming &timing);
+
+        /// 统计最近window帧，window超过容量时按容量计算
+        FrameStatsSummary summarize(size_t window) const;
+
+        /// 每隔interval秒用spdlog输出一次上次报告以来的统计，0表示关闭
+        void set_report_interval(double interval);
+
+        void log_summary(size_t window) const;
+
+        uint64_t get_frame_count() const;
+
+    private:
+        /// 每个槽位用序号做seqlock，序号为奇数表示正在写入
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence{0};
+
+            std::atomic<double> cpu_time{0.0};
+
+            std::atomic<double> gpu_time{0.0};
+
+            std::atomic<double> acquire_wait_time{0.0};
+
+            std::atomic<double> present_wait_time{0.0};
+        };
+
+        std::vector<Slot> m_slots;
+
+        double m_hitch_factor;
+
+        std::atomic<uint64_t> m_frame_count{0};
+
+        // 以下只由写入线程访问
+        std::chrono::duration<double> m_report_interval{0.0};
+
+        std::chrono::steady_clock::time_point m_last_report{};
+
+        uint64_t m_last_report_frame{0};
+    };
+} // namespace comet
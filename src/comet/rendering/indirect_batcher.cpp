@@ -0,0 +1,208 @@
+#include "comet/rendering/indirect_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+IndirectBatcher::IndirectBatcher(Device &device, Queue &queue, uint32_t draw_capacity, uint32_t draw_data_size)
+    : m_device{device}, m_queue{queue}, m_draw_capacity{std::max(draw_capacity, 1u)}, m_draw_data_size{draw_data_size}
+{
+}
+
+IndirectBatcher::~IndirectBatcher()
+{
+    auto &deletion_queue = m_device.get_deletion_queue();
+    for (auto &frame_buffers : m_frame_buffers)
+    {
+        deletion_queue.retire(std::move(frame_buffers.commands));
+        deletion_queue.retire(std::move(frame_buffers.counts));
+        deletion_queue.retire(std::move(frame_buffers.draw_data));
+    }
+}
+
+void IndirectBatcher::begin()
+{
+    // 上一帧已经提交，它的缓冲在这次提交完成之前不能改写
+    if (m_current != SIZE_MAX)
+    {
+        m_frame_buffers[m_current].submitted_value = m_queue.get_last_submitted_value();
+    }
+
+    auto found = std::find_if(m_frame_buffers.begin(), m_frame_buffers.end(), [this](const FrameBuffers &frame_buffers)
+                              { return m_queue.is_complete(frame_buffers.submitted_value); });
+    if (found == m_frame_buffers.end())
+    {
+        m_frame_buffers.emplace_back();
+        allocate(m_frame_buffers.back(), m_draw_capacity);
+        found = std::prev(m_frame_buffers.end());
+    }
+    m_current = std::distance(m_frame_buffers.begin(), found);
+
+    m_draws.clear();
+    m_draw_data.clear();
+    m_batches.clear();
+}
+
+void IndirectBatcher::add(VkPipeline pipeline, const VkDrawIndexedIndirectCommand &command, const void *draw_data)
+{
+    if (m_current == SIZE_MAX)
+    {
+        throw std::runtime_error("indirect batcher is not recording!");
+    }
+
+    m_draws.push_back({pipeline, command, static_cast<uint32_t>(m_draws.size())});
+
+    if (m_draw_data_size > 0)
+    {
+        auto offset = m_draw_data.size();
+        m_draw_data.resize(offset + m_draw_data_size);
+        if (draw_data)
+        {
+            std::memcpy(m_draw_data.data() + offset, draw_data, m_draw_data_size);
+        }
+    }
+}
+
+void IndirectBatcher::end()
+{
+    if (m_draws.empty())
+    {
+        return;
+    }
+
+    // 同一管线的绘制保持添加顺序，相邻的合并成一个批次
+    std::stable_sort(m_draws.begin(), m_draws.end(), [](const Draw &a, const Draw &b)
+                     { return std::less<VkPipeline>{}(a.pipeline, b.pipeline); });
+
+    auto &frame_buffers = m_frame_buffers[m_current];
+    auto draw_count = static_cast<uint32_t>(m_draws.size());
+    if (draw_count > frame_buffers.capacity)
+    {
+        // 这组缓冲的提交已经完成，可以直接替换
+        m_draw_capacity = std::max(draw_count, m_draw_capacity * 2);
+        allocate(frame_buffers, m_draw_capacity);
+    }
+
+    // 没有开启drawIndirectFirstInstance时firstInstance必须为0
+    bool first_instance = m_device.get_enabled_features().drawIndirectFirstInstance == VK_TRUE;
+
+    std::vector<VkDrawIndexedIndirectCommand> commands(draw_count);
+    std::vector<uint8_t> draw_data(m_draw_data.size());
+    for (uint32_t i = 0; i < draw_count; ++i)
+    {
+        const auto &draw = m_draws[i];
+
+        commands[i] = draw.command;
+        commands[i].firstInstance = first_instance ? i : 0;
+
+        if (m_draw_data_size > 0)
+        {
+            std::memcpy(draw_data.data() + static_cast<size_t>(i) * m_draw_data_size,
+                        m_draw_data.data() + static_cast<size_t>(draw.data_index) * m_draw_data_size,
+                        m_draw_data_size);
+        }
+
+        if (m_batches.empty() || m_batches.back().pipeline != draw.pipeline)
+        {
+            m_batches.push_back({draw.pipeline, i, 0});
+        }
+        m_batches.back().draw_count++;
+    }
+
+    std::vector<uint32_t> counts;
+    counts.reserve(m_batches.size());
+    for (const auto &batch : m_batches)
+    {
+        counts.push_back(batch.draw_count);
+    }
+
+    frame_buffers.commands->update(commands.data(), commands.size() * sizeof(VkDrawIndexedIndirectCommand));
+    frame_buffers.counts->update(counts.data(), counts.size() * sizeof(uint32_t));
+    if (frame_buffers.draw_data)
+    {
+        frame_buffers.draw_data->update(draw_data.data(), draw_data.size());
+    }
+}
+
+void IndirectBatcher::record(VkCommandBuffer command_buffer, const BindFunction &bind) const
+{
+    if (m_batches.empty())
+    {
+        return;
+    }
+
+    const auto &frame_buffers = m_frame_buffers[m_current];
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    bool multi_draw = m_device.get_enabled_features().multiDrawIndirect == VK_TRUE;
+
+    for (size_t batch_index = 0; batch_index < m_batches.size(); ++batch_index)
+    {
+        const auto &batch = m_batches[batch_index];
+        VkDeviceSize offset = static_cast<VkDeviceSize>(batch.first_draw) * stride;
+
+        if (m_device.is_draw_indirect_count_enabled())
+        {
+            bind(command_buffer, batch);
+            vkCmdDrawIndexedIndirectCount(command_buffer, frame_buffers.commands->get_handle(), offset,
+                                          frame_buffers.counts->get_handle(), batch_index * sizeof(uint32_t),
+                                          batch.draw_count, stride);
+        }
+        else if (multi_draw)
+        {
+            bind(command_buffer, batch);
+            vkCmdDrawIndexedIndirect(command_buffer, frame_buffers.commands->get_handle(), offset, batch.draw_count, stride);
+        }
+        else
+        {
+            // drawCount只能是0或1，gl_DrawID总是0，每次绘制单独推送自己的序号
+            for (uint32_t i = 0; i < batch.draw_count; ++i)
+            {
+                bind(command_buffer, {batch.pipeline, batch.first_draw + i, 1});
+                vkCmdDrawIndexedIndirect(command_buffer, frame_buffers.commands->get_handle(), offset + i * stride, 1, stride);
+            }
+        }
+    }
+}
+
+const std::vector<IndirectBatcher::Batch> &IndirectBatcher::get_batches() const
+{
+    return m_batches;
+}
+
+uint32_t IndirectBatcher::get_draw_count() const
+{
+    return static_cast<uint32_t>(m_draws.size());
+}
+
+const Buffer *IndirectBatcher::get_draw_data_buffer() const
+{
+    if (m_current == SIZE_MAX)
+    {
+        return nullptr;
+    }
+    return m_frame_buffers[m_current].draw_data.get();
+}
+
+void IndirectBatcher::allocate(FrameBuffers &frame_buffers, uint32_t capacity)
+{
+    // 指令和计数也允许作为存储缓冲，GPU剔除可以直接写入
+    frame_buffers.commands = std::make_unique<Buffer>(m_device, capacity * sizeof(VkDrawIndexedIndirectCommand),
+                                                      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                      VMA_MEMORY_USAGE_CPU_TO_GPU);
+    frame_buffers.counts = std::make_unique<Buffer>(m_device, capacity * sizeof(uint32_t),
+                                                    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                    VMA_MEMORY_USAGE_CPU_TO_GPU);
+    if (m_draw_data_size > 0)
+    {
+        frame_buffers.draw_data = std::make_unique<Buffer>(m_device, static_cast<VkDeviceSize>(capacity) * m_draw_data_size,
+                                                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                           VMA_MEMORY_USAGE_CPU_TO_GPU);
+    }
+    frame_buffers.capacity = capacity;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/buffer.h"
+#include "comet/vulkan/queue.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 把使用同一管线的绘制合并成一次多重间接绘制，CPU开销不再随绘制数量线性增长。
+    /// 绘制按管线排序后连续存放，每次绘制的数据写入存储缓冲的对应位置，着色器用
+    /// first_draw(推送常量)+gl_DrawID索引；设备支持drawIndirectFirstInstance时
+    /// firstInstance就是全局绘制序号，也可以直接用gl_InstanceIndex索引
+    class IndirectBatcher
+    {
+    public:
+        /// 使用同一管线的连续绘制
+        struct Batch
+        {
+            VkPipeline pipeline;
+
+            /// 在全部绘制中的起始序号
+            uint32_t first_draw;
+
+            uint32_t draw_count;
+        };
+
+        /// 每个批次绘制之前调用，绑定管线并推送first_draw等常量。
+        /// 设备不支持multiDrawIndirect时每次绘制调用一次，batch只包含这一次绘制
+        using BindFunction = std::function<void(VkCommandBuffer command_buffer, const Batch &batch)>;
+
+    public:
+        /// draw_capacity只是初始容量，绘制更多时自动扩容；draw_data_size为每次绘制的数据大小，可以为0
+        IndirectBatcher(Device &device, Queue &queue, uint32_t draw_capacity = 1024, uint32_t draw_data_size = 0);
+
+        IndirectBatcher(const IndirectBatcher &) = delete;
+
+        IndirectBatcher(IndirectBatcher &&) = delete;
+
+        /// 缓冲交给设备的延迟删除队列
+        ~IndirectBatcher();
+
+        IndirectBatcher &operator=(const IndirectBatcher &) = delete;
+
+        IndirectBatcher &operator=(IndirectBatcher &&) = delete;
+
+        /// 开始收集新一帧的绘制，上一帧必须已经提交到queue
+        void begin();
+
+        /// 添加一次绘制，firstInstance会被改写为绘制序号，draw_data为draw_data_size字节
+        void add(VkPipeline pipeline, const VkDrawIndexedIndirectCommand &command, const void *draw_data = nullptr);
+
+        /// 按管线排序并写入GPU缓冲，之后可以录制
+        void end();
+
+        /// 每个批次一次vkCmdDrawIndexedIndirectCount，不支持时用vkCmdDrawIndexedIndirect，
+        /// 连multiDrawIndirect也不支持时逐条间接绘制。索引缓冲需要调用者绑定
+        void record(VkCommandBuffer command_buffer, const BindFunction &bind) const;
+
+        const std::vector<Batch> &get_batches() const;
+
+        uint32_t get_draw_count() const;
+
+        /// 当前帧的绘制数据，每帧可能是不同的缓冲，描述符需要在end之后更新
+        const Buffer *get_draw_data_buffer() const;
+
+    private:
+        /// 一帧使用的GPU缓冲，提交完成后才能被下一帧复用
+        struct FrameBuffers
+        {
+            std::unique_ptr<Buffer> commands;
+
+            /// 每个批次的绘制数量，之后GPU剔除可以直接改写
+            std::unique_ptr<Buffer> counts;
+
+            std::unique_ptr<Buffer> draw_data;
+
+            uint32_t capacity{0};
+
+            /// 使用这组缓冲的最后一次提交
+            uint64_t submitted_value{0};
+        };
+
+        struct Draw
+        {
+            VkPipeline pipeline;
+
+            VkDrawIndexedIndirectCommand command;
+
+            /// 在m_draw_data中的序号，即添加的顺序
+            uint32_t data_index;
+        };
+
+        void allocate(FrameBuffers &frame_buffers, uint32_t capacity);
+
+    private:
+        Device &m_device;
+
+        Queue &m_queue;
+
+        uint32_t m_draw_capacity;
+
+        uint32_t m_draw_data_size;
+
+        std::vector<FrameBuffers> m_frame_buffers;
+
+        /// 当前帧使用的缓冲在m_frame_buffers中的序号
+        size_t m_current{SIZE_MAX};
+
+        std::vector<Draw> m_draws;
+
+        std::vector<uint8_t> m_draw_data;
+
+        std::vector<Batch> m_batches;
+    };
+} // namespace comet
@@ -0,0 +1,101 @@
+#include "comet/rendering/parallel_recorder.h"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+using namespace comet;
+
+namespace
+{
+void record_batch(FrameContext &frame, uint32_t thread_index,
+                  const VkCommandBufferInheritanceInfo &inheritance,
+                  size_t begin, size_t end,
+                  const ParallelRecorder::RecordFunction &record_function,
+                  CommandBuffer *&result)
+{
+    auto &command_buffer = frame.request_command_buffer(thread_index, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritance);
+    record_function(command_buffer, begin, end);
+    command_buffer.end();
+
+    result = &command_buffer;
+}
+} // namespace
+
+ParallelRecorder::ParallelRecorder(ThreadPool &thread_pool, size_t min_batch_size)
+    : m_thread_pool{thread_pool}, m_min_batch_size{std::max<size_t>(min_batch_size, 1)}
+{
+}
+
+void ParallelRecorder::record(FrameContext &frame, CommandBuffer &primary,
+                              const VkCommandBufferInheritanceInfo &inheritance,
+                              size_t draw_count, const RecordFunction &record_function)
+{
+    if (draw_count == 0)
+    {
+        return;
+    }
+
+    if (frame.get_thread_count() < get_required_thread_count())
+    {
+        throw std::runtime_error("frame context has fewer command pools than recording threads!");
+    }
+
+    size_t worker_count = m_thread_pool.get_thread_count();
+    size_t batch_count = std::min(worker_count, (draw_count + m_min_batch_size - 1) / m_min_batch_size);
+
+    std::vector<CommandBuffer *> secondaries(batch_count, nullptr);
+
+    // 只有一批时直接在调用线程录制，省去线程切换
+    if (batch_count <= 1)
+    {
+        record_batch(frame, 0, inheritance, 0, draw_count, record_function, secondaries[0]);
+    }
+    else
+    {
+        size_t batch_size = (draw_count + batch_count - 1) / batch_count;
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(batch_count);
+        for (size_t i = 0; i < batch_count; ++i)
+        {
+            size_t begin = i * batch_size;
+            size_t end = std::min(begin + batch_size, draw_count);
+            auto &result = secondaries[i];
+            futures.push_back(m_thread_pool.push([&frame, &inheritance, &record_function, &result, begin, end](uint32_t thread_index)
+                                                 { record_batch(frame, thread_index + 1, inheritance, begin, end, record_function, result); }));
+        }
+
+        // 任务引用了局部变量，即使有任务失败也要等待全部完成
+        std::exception_ptr exception;
+        for (auto &future : futures)
+        {
+            try
+            {
+                future.get();
+            }
+            catch (...)
+            {
+                if (!exception)
+                {
+                    exception = std::current_exception();
+                }
+            }
+        }
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    // 按绘制列表的顺序执行
+    primary.execute_commands(secondaries);
+}
+
+uint32_t ParallelRecorder::get_required_thread_count() const
+{
+    return m_thread_pool.get_thread_count() + 1;
+}
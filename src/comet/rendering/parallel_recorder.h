@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "volk.h"
+
+#include "comet/core/thread_pool.h"
+#include "comet/rendering/frame_context.h"
+#include "comet/vulkan/command_buffer.h"
+
+namespace comet
+{
+    /// 把一个渲染通道的绘制列表切分到工作线程，各自录制次级命令缓冲，
+    /// 再按原顺序在主命令缓冲中执行。
+    /// 工作线程i使用FrameContext中索引为i+1的命令池，索引0留给调用线程
+    class ParallelRecorder
+    {
+    public:
+        /// 录制[begin, end)范围内的绘制，在工作线程中调用
+        using RecordFunction = std::function<void(CommandBuffer &command_buffer, size_t begin, size_t end)>;
+
+    public:
+        /// 每批至少min_batch_size个绘制，绘制太少时拆分的开销大于收益
+        explicit ParallelRecorder(ThreadPool &thread_pool, size_t min_batch_size = 256);
+
+        ParallelRecorder(const ParallelRecorder &) = delete;
+
+        ParallelRecorder(ParallelRecorder &&) = delete;
+
+        ~ParallelRecorder() = default;
+
+        ParallelRecorder &operator=(const ParallelRecorder &) = delete;
+
+        ParallelRecorder &operator=(ParallelRecorder &&) = delete;
+
+        /// primary必须已经以VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS开始inheritance指定的子通道。
+        /// 次级命令缓冲不继承动态状态和绑定，record_function需要自行设置
+        void record(FrameContext &frame, CommandBuffer &primary,
+                    const VkCommandBufferInheritanceInfo &inheritance,
+                    size_t draw_count, const RecordFunction &record_function);
+
+        /// FrameContext至少需要的命令池数量
+        uint32_t get_required_thread_count() const;
+
+    private:
+        ThreadPool &m_thread_pool;
+
+        size_t m_min_batch_size;
+    };
+} // namespace comet
@@ -0,0 +1,164 @@
+#include "comet/rendering/pipeline_hot_reload.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+PipelineHotReload::PipelineHotReload(Device &device, ShaderCompiler &shader_compiler, ThreadPool &thread_pool)
+    : m_device{device}, m_shader_compiler{shader_compiler}, m_thread_pool{thread_pool}
+{
+}
+
+PipelineHotReload::~PipelineHotReload()
+{
+    for (auto &entry : m_entries)
+    {
+        // 重建出来的管线还没有被使用过，可以直接销毁
+        if (entry.pending.valid())
+        {
+            try
+            {
+                auto result = entry.pending.get();
+                vkDestroyPipeline(m_device.get_handle(), result.pipeline, nullptr);
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+
+        retire(entry.pipeline);
+    }
+}
+
+uint32_t PipelineHotReload::add(const std::string &name, const std::vector<ShaderVariant> &variants, BuildFunction build_function)
+{
+    Entry entry{};
+    entry.name = name;
+    entry.variants = variants;
+    entry.build = std::move(build_function);
+
+    auto result = build(entry.name, entry.variants, entry.build);
+    entry.pipeline = result.pipeline;
+    entry.dependencies = std::move(result.dependencies);
+    watch(entry);
+
+    m_entries.push_back(std::move(entry));
+    return static_cast<uint32_t>(m_entries.size() - 1);
+}
+
+VkPipeline PipelineHotReload::get_pipeline(uint32_t id) const
+{
+    return m_entries.at(id).pipeline;
+}
+
+uint32_t PipelineHotReload::update()
+{
+    auto changed = m_file_watcher.poll();
+    for (auto &entry : m_entries)
+    {
+        bool affected = std::any_of(entry.dependencies.begin(), entry.dependencies.end(), [&changed](const std::filesystem::path &dependency)
+                                    { return std::find(changed.begin(), changed.end(), dependency) != changed.end(); });
+        if (affected)
+        {
+            entry.stale = true;
+        }
+    }
+
+    uint32_t swapped = 0;
+    for (auto &entry : m_entries)
+    {
+        if (entry.pending.valid() && entry.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            try
+            {
+                auto result = entry.pending.get();
+
+                // 已经录制的帧仍在使用旧管线
+                retire(entry.pipeline);
+                entry.pipeline = result.pipeline;
+                entry.dependencies = std::move(result.dependencies);
+                watch(entry);
+
+                spdlog::info("reloaded pipeline {}", entry.name);
+                swapped++;
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error("failed to reload pipeline {}: {}", entry.name, e.what());
+            }
+        }
+
+        // 同一个管线同时只有一个重建，期间的修改合并到下一次
+        if (entry.stale && !entry.pending.valid())
+        {
+            entry.stale = false;
+
+            // 复制参数，添加新条目时m_entries可能重新分配
+            auto task = std::make_shared<std::packaged_task<Result()>>([this, name = entry.name, variants = entry.variants, build_function = entry.build]()
+                                                                        { return build(name, variants, build_function); });
+            entry.pending = task->get_future();
+            m_thread_pool.push([task](uint32_t)
+                               { (*task)(); });
+        }
+    }
+
+    return swapped;
+}
+
+PipelineHotReload::Result PipelineHotReload::build(const std::string &name, const std::vector<ShaderVariant> &variants,
+                                                   const BuildFunction &build_function)
+{
+    Result result{};
+
+    // 在同一线程中顺序编译，不占用线程池中的其他线程等待
+    std::vector<ShaderBinary> shaders;
+    shaders.reserve(variants.size());
+    for (const auto &variant : variants)
+    {
+        shaders.push_back(m_shader_compiler.compile(variant));
+        for (const auto &dependency : shaders.back().dependencies)
+        {
+            if (std::find(result.dependencies.begin(), result.dependencies.end(), dependency) == result.dependencies.end())
+            {
+                result.dependencies.push_back(dependency);
+            }
+        }
+    }
+
+    result.pipeline = build_function(shaders);
+    if (result.pipeline == VK_NULL_HANDLE)
+    {
+        throw std::runtime_error("failed to build pipeline " + name + "!");
+    }
+
+    return result;
+}
+
+void PipelineHotReload::watch(Entry &entry)
+{
+    // 依赖以绝对路径比较，与FileWatcher返回的路径一致
+    for (auto &dependency : entry.dependencies)
+    {
+        dependency = std::filesystem::absolute(dependency).lexically_normal();
+        m_file_watcher.watch(dependency);
+    }
+}
+
+void PipelineHotReload::retire(VkPipeline pipeline)
+{
+    if (pipeline == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    VkDevice device = m_device.get_handle();
+    m_device.get_deletion_queue().push([device, pipeline]()
+                                       { vkDestroyPipeline(device, pipeline, nullptr); });
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/core/file_watcher.h"
+#include "comet/core/thread_pool.h"
+#include "comet/rendering/shader_compiler.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 着色器热重载：源文件或被包含的文件修改后，在线程池中重新编译并创建管线，
+    /// 完成前一直使用旧管线；update在帧边界换上新管线，旧管线交给设备的延迟删除队列。
+    /// 管线由它持有，只能在渲染线程调用update和get_pipeline
+    class PipelineHotReload
+    {
+    public:
+        /// 用编译好的着色器创建管线，在工作线程中调用，不能访问渲染线程会修改的状态
+        using BuildFunction = std::function<VkPipeline(const std::vector<ShaderBinary> &shaders)>;
+
+    public:
+        PipelineHotReload(Device &device, ShaderCompiler &shader_compiler, ThreadPool &thread_pool);
+
+        PipelineHotReload(const PipelineHotReload &) = delete;
+
+        PipelineHotReload(PipelineHotReload &&) = delete;
+
+        /// 等待进行中的重建，管线交给延迟删除队列
+        ~PipelineHotReload();
+
+        PipelineHotReload &operator=(const PipelineHotReload &) = delete;
+
+        PipelineHotReload &operator=(PipelineHotReload &&) = delete;
+
+        /// 立即编译并创建管线，之后监视它的所有源文件。返回用于get_pipeline的序号
+        uint32_t add(const std::string &name, const std::vector<ShaderVariant> &variants, BuildFunction build_function);
+
+        /// 当前可用的管线，update换上新管线后会变化
+        VkPipeline get_pipeline(uint32_t id) const;
+
+        /// 每帧开始录制前调用：检查文件修改，启动后台重建，换上已经完成的管线。
+        /// 编译失败时输出日志并保留旧管线。返回这次换上的管线数量
+        uint32_t update();
+
+    private:
+        struct Result
+        {
+            VkPipeline pipeline{VK_NULL_HANDLE};
+
+            std::vector<std::filesystem::path> dependencies;
+        };
+
+        struct Entry
+        {
+            std::string name;
+
+            std::vector<ShaderVariant> variants;
+
+            BuildFunction build;
+
+            VkPipeline pipeline{VK_NULL_HANDLE};
+
+            std::vector<std::filesystem::path> dependencies;
+
+            /// 进行中的重建
+            std::future<Result> pending;
+
+            /// 重建开始后又有修改，完成后需要再重建一次
+            bool stale{false};
+        };
+
+        /// 可能在工作线程中调用，只使用传入的参数
+        Result build(const std::string &name, const std::vector<ShaderVariant> &variants, const BuildFunction &build_function);
+
+        void watch(Entry &entry);
+
+        void retire(VkPipeline pipeline);
+
+    private:
+        Device &m_device;
+
+        ShaderCompiler &m_shader_compiler;
+
+        ThreadPool &m_thread_pool;
+
+        FileWatcher m_file_watcher;
+
+        std::vector<Entry> m_entries;
+    };
+} // namespace comet
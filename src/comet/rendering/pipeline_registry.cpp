@@ -0,0 +1,410 @@
+#include "comet/rendering/pipeline_registry.h"
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "spdlog/spdlog.h"
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+namespace
+{
+/// 把状态逐项写成字节串，既是哈希表的键也用于精确比较
+class KeyWriter
+{
+public:
+    template <typename T>
+    void write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "key fields must be trivially copyable");
+        m_data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void write(const std::vector<T> &values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "key fields must be trivially copyable");
+        write(static_cast<uint64_t>(values.size()));
+        m_data.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    void write(const std::string &value)
+    {
+        write(static_cast<uint64_t>(value.size()));
+        m_data.append(value);
+    }
+
+    void write(const PipelineShader &shader)
+    {
+        write(shader.stage);
+        write(shader.entry_point);
+        write(shader.spirv);
+        write(shader.specialization.get_entries());
+        write(shader.specialization.get_data());
+    }
+
+    std::string take()
+    {
+        return std::move(m_data);
+    }
+
+private:
+    std::string m_data;
+};
+
+VkShaderModule create_shader_module(const Device &device, const std::vector<uint32_t> &spirv)
+{
+    VkShaderModuleCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    create_info.codeSize = spirv.size() * sizeof(uint32_t);
+    create_info.pCode = spirv.data();
+
+    VkShaderModule shader_module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(device.get_handle(), &create_info, nullptr, &shader_module) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create shader module!");
+    }
+    return shader_module;
+}
+
+/// 管线创建后着色器模块就不再需要。阶段信息引用shaders中的字符串和特化数据，shaders要活得比它久
+class ShaderModules
+{
+public:
+    ShaderModules(const Device &device, const std::vector<PipelineShader> &shaders)
+        : m_device{device}
+    {
+        // 阶段信息指向这里的特化信息，不能重新分配
+        m_specialization_infos.reserve(shaders.size());
+        for (const auto &shader : shaders)
+        {
+            m_specialization_infos.push_back(shader.specialization.get_info());
+
+            VkPipelineShaderStageCreateInfo stage{};
+            stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stage.stage = shader.stage;
+            try
+            {
+                stage.module = create_shader_module(device, shader.spirv);
+            }
+            catch (const std::exception &)
+            {
+                destroy();
+                throw;
+            }
+            stage.pName = shader.entry_point.c_str();
+            stage.pSpecializationInfo = shader.specialization.empty() ? nullptr : &m_specialization_infos.back();
+            m_stages.push_back(stage);
+        }
+    }
+
+    ~ShaderModules()
+    {
+        destroy();
+    }
+
+    const std::vector<VkPipelineShaderStageCreateInfo> &get_stages() const
+    {
+        return m_stages;
+    }
+
+private:
+    void destroy()
+    {
+        for (const auto &stage : m_stages)
+        {
+            vkDestroyShaderModule(m_device.get_handle(), stage.module, nullptr);
+        }
+        m_stages.clear();
+    }
+
+private:
+    const Device &m_device;
+
+    std::vector<VkSpecializationInfo> m_specialization_infos;
+
+    std::vector<VkPipelineShaderStageCreateInfo> m_stages;
+};
+} // namespace
+
+bool PipelineHandle::is_valid() const
+{
+    return index != UINT32_MAX;
+}
+
+PipelineRegistry::PipelineRegistry(Device &device, PipelineCache &pipeline_cache, ThreadPool &thread_pool)
+    : m_device{device}, m_pipeline_cache{pipeline_cache}, m_thread_pool{thread_pool}
+{
+    for (uint32_t i = 0; i < m_thread_pool.get_thread_count(); ++i)
+    {
+        m_worker_caches.push_back(m_pipeline_cache.create_worker_cache());
+    }
+}
+
+PipelineRegistry::~PipelineRegistry()
+{
+    VkDevice device = m_device.get_handle();
+    for (auto &entry : m_entries)
+    {
+        entry.pending.wait();
+
+        VkPipeline pipeline = entry.pipeline;
+        if (pipeline != VK_NULL_HANDLE)
+        {
+            m_device.get_deletion_queue().push([device, pipeline]()
+                                               { vkDestroyPipeline(device, pipeline, nullptr); });
+        }
+    }
+}
+
+PipelineHandle PipelineRegistry::request(const GraphicsPipelineDesc &desc)
+{
+    if (!desc.layout)
+    {
+        throw std::runtime_error("graphics pipeline requires a pipeline layout!");
+    }
+
+    KeyWriter key;
+    key.write(static_cast<uint32_t>(VK_PIPELINE_BIND_POINT_GRAPHICS));
+    key.write(static_cast<uint64_t>(desc.shaders.size()));
+    for (const auto &shader : desc.shaders)
+    {
+        key.write(shader);
+    }
+    key.write(desc.vertex_bindings);
+    key.write(desc.vertex_attributes);
+    key.write(desc.topology);
+    key.write(desc.polygon_mode);
+    key.write(desc.cull_mode);
+    key.write(desc.front_face);
+    key.write(desc.samples);
+    key.write(desc.depth_test);
+    key.write(desc.depth_write);
+    key.write(desc.depth_compare);
+    key.write(desc.blend_attachments);
+    key.write(desc.dynamic_states);
+    // 布局和渲染通道已经在ResourceCache中去重，句柄相同就是相同的对象
+    key.write(desc.layout->get_handle());
+    key.write(desc.render_pass ? desc.render_pass->get_handle() : VK_NULL_HANDLE);
+    key.write(desc.subpass);
+    key.write(desc.color_formats);
+    key.write(desc.depth_format);
+
+    const Device &device = m_device;
+    return request(key.take(), desc.layout, desc.render_pass, [&device, desc](VkPipelineCache pipeline_cache)
+                   { return create_graphics_pipeline(device, pipeline_cache, desc); });
+}
+
+PipelineHandle PipelineRegistry::request(const ComputePipelineDesc &desc)
+{
+    if (!desc.layout)
+    {
+        throw std::runtime_error("compute pipeline requires a pipeline layout!");
+    }
+
+    KeyWriter key;
+    key.write(static_cast<uint32_t>(VK_PIPELINE_BIND_POINT_COMPUTE));
+    key.write(desc.shader);
+    key.write(desc.layout->get_handle());
+
+    const Device &device = m_device;
+    return request(key.take(), desc.layout, nullptr, [&device, desc](VkPipelineCache pipeline_cache)
+                   { return create_compute_pipeline(device, pipeline_cache, desc); });
+}
+
+VkPipeline PipelineRegistry::get(PipelineHandle handle) const
+{
+    return get_entry(handle).pipeline;
+}
+
+VkPipeline PipelineRegistry::get(PipelineHandle handle, PipelineHandle fallback) const
+{
+    VkPipeline pipeline = get(handle);
+    return pipeline != VK_NULL_HANDLE ? pipeline : get(fallback);
+}
+
+PipelineStatus PipelineRegistry::get_status(PipelineHandle handle) const
+{
+    return get_entry(handle).status;
+}
+
+VkPipeline PipelineRegistry::wait(PipelineHandle handle)
+{
+    const auto &entry = get_entry(handle);
+    entry.pending.wait();
+    return entry.pipeline;
+}
+
+uint32_t PipelineRegistry::get_pending_count() const
+{
+    return m_pending_count;
+}
+
+size_t PipelineRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+VkPipeline PipelineRegistry::create_graphics_pipeline(const Device &device, VkPipelineCache pipeline_cache, const GraphicsPipelineDesc &desc)
+{
+    ShaderModules shader_modules(device, desc.shaders);
+
+    VkPipelineVertexInputStateCreateInfo vertex_input{};
+    vertex_input.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertex_input.vertexBindingDescriptionCount = static_cast<uint32_t>(desc.vertex_bindings.size());
+    vertex_input.pVertexBindingDescriptions = desc.vertex_bindings.data();
+    vertex_input.vertexAttributeDescriptionCount = static_cast<uint32_t>(desc.vertex_attributes.size());
+    vertex_input.pVertexAttributeDescriptions = desc.vertex_attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+    input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly.topology = desc.topology;
+
+    // 视口和裁剪是动态状态，这里只需要数量
+    VkPipelineViewportStateCreateInfo viewport_state{};
+    viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state.viewportCount = 1;
+    viewport_state.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterization{};
+    rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterization.polygonMode = desc.polygon_mode;
+    rasterization.cullMode = desc.cull_mode;
+    rasterization.frontFace = desc.front_face;
+    rasterization.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisample{};
+    multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisample.rasterizationSamples = desc.samples;
+    multisample.minSampleShading = 1.0f;
+
+    VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+    depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depth_stencil.depthTestEnable = desc.depth_test ? VK_TRUE : VK_FALSE;
+    depth_stencil.depthWriteEnable = desc.depth_write ? VK_TRUE : VK_FALSE;
+    depth_stencil.depthCompareOp = desc.depth_compare;
+    depth_stencil.maxDepthBounds = 1.0f;
+
+    VkPipelineColorBlendStateCreateInfo color_blend{};
+    color_blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blend.logicOp = VK_LOGIC_OP_COPY;
+    color_blend.attachmentCount = static_cast<uint32_t>(desc.blend_attachments.size());
+    color_blend.pAttachments = desc.blend_attachments.data();
+
+    std::vector<VkDynamicState> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    dynamic_states.insert(dynamic_states.end(), desc.dynamic_states.begin(), desc.dynamic_states.end());
+    VkPipelineDynamicStateCreateInfo dynamic_state{};
+    dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state.dynamicStateCount = static_cast<uint32_t>(dynamic_states.size());
+    dynamic_state.pDynamicStates = dynamic_states.data();
+
+    const auto &stages = shader_modules.get_stages();
+    VkGraphicsPipelineCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    create_info.stageCount = static_cast<uint32_t>(stages.size());
+    create_info.pStages = stages.data();
+    create_info.pVertexInputState = &vertex_input;
+    create_info.pInputAssemblyState = &input_assembly;
+    create_info.pViewportState = &viewport_state;
+    create_info.pRasterizationState = &rasterization;
+    create_info.pMultisampleState = &multisample;
+    create_info.pDepthStencilState = &depth_stencil;
+    create_info.pColorBlendState = &color_blend;
+    create_info.pDynamicState = &dynamic_state;
+    create_info.layout = desc.layout->get_handle();
+    create_info.renderPass = desc.render_pass ? desc.render_pass->get_handle() : VK_NULL_HANDLE;
+    create_info.subpass = desc.subpass;
+    create_info.basePipelineIndex = -1;
+
+    VkPipelineRenderingCreateInfoKHR rendering{};
+    rendering.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    rendering.colorAttachmentCount = static_cast<uint32_t>(desc.color_formats.size());
+    rendering.pColorAttachmentFormats = desc.color_formats.data();
+    rendering.depthAttachmentFormat = desc.depth_format;
+    if (desc.depth_format == VK_FORMAT_D16_UNORM_S8_UINT || desc.depth_format == VK_FORMAT_D24_UNORM_S8_UINT ||
+        desc.depth_format == VK_FORMAT_D32_SFLOAT_S8_UINT)
+    {
+        rendering.stencilAttachmentFormat = desc.depth_format;
+    }
+    if (!desc.render_pass)
+    {
+        create_info.pNext = &rendering;
+    }
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &pipeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create graphics pipeline!");
+    }
+    return pipeline;
+}
+
+VkPipeline PipelineRegistry::create_compute_pipeline(const Device &device, VkPipelineCache pipeline_cache, const ComputePipelineDesc &desc)
+{
+    std::vector<PipelineShader> shaders = {desc.shader};
+    ShaderModules shader_modules(device, shaders);
+
+    VkComputePipelineCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    create_info.stage = shader_modules.get_stages().front();
+    create_info.layout = desc.layout->get_handle();
+    create_info.basePipelineIndex = -1;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateComputePipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &pipeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create compute pipeline!");
+    }
+    return pipeline;
+}
+
+PipelineHandle PipelineRegistry::request(std::string key, const std::shared_ptr<PipelineLayout> &layout, const std::shared_ptr<RenderPass> &render_pass,
+                                         std::function<VkPipeline(VkPipelineCache)> create)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_indices.find(key);
+    if (found != m_indices.end())
+    {
+        return {found->second};
+    }
+
+    uint32_t index = static_cast<uint32_t>(m_entries.size());
+    m_indices.emplace(std::move(key), index);
+    Entry &entry = m_entries.emplace_back();
+    entry.layout = layout;
+    entry.render_pass = render_pass;
+
+    // 每个线程写自己的缓存，不争用同一个缓存的内部锁
+    m_pending_count++;
+    entry.pending = m_thread_pool.push([this, &entry, index, create = std::move(create)](uint32_t thread_index)
+                                       {
+                                           try
+                                           {
+                                               entry.pipeline = create(m_worker_caches[thread_index]);
+                                               entry.status = PipelineStatus::Ready;
+                                           }
+                                           catch (const std::exception &e)
+                                           {
+                                               spdlog::error("failed to create pipeline {}: {}", index, e.what());
+                                               entry.status = PipelineStatus::Failed;
+                                           }
+                                           m_pending_count--;
+                                       })
+                        .share();
+
+    return {index};
+}
+
+const PipelineRegistry::Entry &PipelineRegistry::get_entry(PipelineHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!handle.is_valid() || handle.index >= m_entries.size())
+    {
+        throw std::runtime_error("invalid pipeline handle!");
+    }
+    return m_entries[handle.index];
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/core/thread_pool.h"
+#include "comet/vulkan/pipeline_cache.h"
+#include "comet/vulkan/pipeline_layout.h"
+#include "comet/vulkan/render_pass.h"
+#include "comet/vulkan/specialization_constants.h"
+
+namespace comet
+{
+    class Device;
+
+    struct PipelineShader
+    {
+        VkShaderStageFlagBits stage;
+
+        std::vector<uint32_t> spirv;
+
+        std::string entry_point{"main"};
+
+        /// 不同的值是不同的管线变体，驱动可以按常量折叠分支
+        SpecializationConstants specialization;
+    };
+
+    /// 图形管线的全部状态，视口和裁剪总是动态的
+    struct GraphicsPipelineDesc
+    {
+        std::vector<PipelineShader> shaders;
+
+        std::vector<VkVertexInputBindingDescription> vertex_bindings;
+
+        std::vector<VkVertexInputAttributeDescription> vertex_attributes;
+
+        VkPrimitiveTopology topology{VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+
+        VkPolygonMode polygon_mode{VK_POLYGON_MODE_FILL};
+
+        VkCullModeFlags cull_mode{VK_CULL_MODE_BACK_BIT};
+
+        VkFrontFace front_face{VK_FRONT_FACE_CLOCKWISE};
+
+        VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+
+        bool depth_test{false};
+
+        bool depth_write{false};
+
+        VkCompareOp depth_compare{VK_COMPARE_OP_LESS_OR_EQUAL};
+
+        /// 每个颜色附件一项
+        std::vector<VkPipelineColorBlendAttachmentState> blend_attachments;
+
+        /// 视口和裁剪之外的动态状态
+        std::vector<VkDynamicState> dynamic_states;
+
+        std::shared_ptr<PipelineLayout> layout;
+
+        /// 为空时使用动态渲染，附件格式由color_formats和depth_format给出
+        std::shared_ptr<RenderPass> render_pass;
+
+        uint32_t subpass{0};
+
+        std::vector<VkFormat> color_formats;
+
+        VkFormat depth_format{VK_FORMAT_UNDEFINED};
+    };
+
+    struct ComputePipelineDesc
+    {
+        PipelineShader shader;
+
+        std::shared_ptr<PipelineLayout> layout;
+    };
+
+    /// 注册表中的管线，在PipelineRegistry销毁前一直有效
+    struct PipelineHandle
+    {
+        uint32_t index{UINT32_MAX};
+
+        bool is_valid() const;
+    };
+
+    enum class PipelineStatus
+    {
+        Pending,
+        Ready,
+        Failed
+    };
+
+    /// 按完整状态去重的管线注册表：request立即返回句柄，管线在线程池中创建，
+    /// 完成前get返回VK_NULL_HANDLE(或后备管线)，绘制可以跳过或先用后备管线，不会卡住渲染线程。
+    /// 每个工作线程使用自己的管线缓存，PipelineCache::save时合并进主缓存。
+    /// 可以在任意线程调用，管线在注册表销毁时交给设备的延迟删除队列
+    class PipelineRegistry
+    {
+    public:
+        PipelineRegistry(Device &device, PipelineCache &pipeline_cache, ThreadPool &thread_pool);
+
+        PipelineRegistry(const PipelineRegistry &) = delete;
+
+        PipelineRegistry(PipelineRegistry &&) = delete;
+
+        /// 等待进行中的创建
+        ~PipelineRegistry();
+
+        PipelineRegistry &operator=(const PipelineRegistry &) = delete;
+
+        PipelineRegistry &operator=(PipelineRegistry &&) = delete;
+
+        /// 状态与之前的请求相同时返回同一个句柄，否则开始在后台创建
+        PipelineHandle request(const GraphicsPipelineDesc &desc);
+
+        PipelineHandle request(const ComputePipelineDesc &desc);
+
+        /// 没有完成或创建失败时返回VK_NULL_HANDLE
+        VkPipeline get(PipelineHandle handle) const;
+
+        /// handle没有完成时使用fallback
+        VkPipeline get(PipelineHandle handle, PipelineHandle fallback) const;
+
+        PipelineStatus get_status(PipelineHandle handle) const;
+
+        /// 阻塞到创建完成，用于必须马上可用的管线
+        VkPipeline wait(PipelineHandle handle);
+
+        /// 还没有完成的创建数量
+        uint32_t get_pending_count() const;
+
+        size_t size() const;
+
+        /// 同步创建，不经过注册表，返回的管线由调用者销毁
+        static VkPipeline create_graphics_pipeline(const Device &device, VkPipelineCache pipeline_cache, const GraphicsPipelineDesc &desc);
+
+        static VkPipeline create_compute_pipeline(const Device &device, VkPipelineCache pipeline_cache, const ComputePipelineDesc &desc);
+
+    private:
+        struct Entry
+        {
+            std::atomic<VkPipeline> pipeline{VK_NULL_HANDLE};
+
+            std::atomic<PipelineStatus> status{PipelineStatus::Pending};
+
+            std::shared_future<void> pending;
+
+            /// key中记录的是句柄，持有它们直到注册表销毁，句柄不会被新对象复用
+            std::shared_ptr<PipelineLayout> layout;
+
+            std::shared_ptr<RenderPass> render_pass;
+        };
+
+        /// key为序列化的完整状态，create的参数是执行它的工作线程的管线缓存
+        PipelineHandle request(std::string key, const std::shared_ptr<PipelineLayout> &layout, const std::shared_ptr<RenderPass> &render_pass,
+                               std::function<VkPipeline(VkPipelineCache)> create);
+
+        const Entry &get_entry(PipelineHandle handle) const;
+
+    private:
+        Device &m_device;
+
+        PipelineCache &m_pipeline_cache;
+
+        ThreadPool &m_thread_pool;
+
+        /// 按工作线程索引
+        std::vector<VkPipelineCache> m_worker_caches;
+
+        mutable std::mutex m_mutex;
+
+        std::unordered_map<std::string, uint32_t> m_indices;
+
+        /// 扩容时元素不移动，工作线程可以直接写入
+        std::deque<Entry> m_entries;
+
+        std::atomic<uint32_t> m_pending_count{0};
+    };
+} // namespace comet
@@ -0,0 +1,657 @@
+#include "comet/rendering/render_graph.h"
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+#include "comet/vulkan/barrier.h"
+
+using namespace comet;
+
+namespace
+{
+const VkImageSubresourceRange WHOLE_IMAGE{0, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+
+/// synchronization2的阶段转换为VkSubmitInfo使用的阶段，没有对应位时退化为ALL_COMMANDS
+inline VkPipelineStageFlags to_submit_stages(VkPipelineStageFlags2KHR stage_mask)
+{
+    if (stage_mask > UINT32_MAX)
+    {
+        return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    return static_cast<VkPipelineStageFlags>(stage_mask);
+}
+} // namespace
+
+bool RenderGraphHandle::is_valid() const
+{
+    return index != UINT32_MAX;
+}
+
+bool TransientImageDesc::operator==(const TransientImageDesc &other) const
+{
+    return extent.width == other.extent.width && extent.height == other.extent.height &&
+           format == other.format && usage == other.usage;
+}
+
+bool RenderGraph::TransientPlan::operator==(const TransientPlan &other) const
+{
+    return desc == other.desc && first_use == other.first_use && last_use == other.last_use && async == other.async;
+}
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph &graph, uint32_t pass_index)
+    : m_graph{graph}, m_pass_index{pass_index}
+{
+}
+
+RenderGraphHandle RenderGraph::PassBuilder::create(const std::string &name, const TransientImageDesc &desc)
+{
+    Resource resource{};
+    resource.name = name;
+    resource.transient = true;
+    resource.desc = desc;
+    m_graph.m_resources.push_back(resource);
+
+    return {static_cast<uint32_t>(m_graph.m_resources.size() - 1)};
+}
+
+void RenderGraph::PassBuilder::read(RenderGraphHandle handle, const ImageState &state)
+{
+    m_graph.get_resource(handle);
+    m_graph.m_passes[m_pass_index].accesses.push_back({handle.index, state, false, false});
+}
+
+void RenderGraph::PassBuilder::write(RenderGraphHandle handle, const ImageState &state, bool discard)
+{
+    m_graph.get_resource(handle);
+    m_graph.m_passes[m_pass_index].accesses.push_back({handle.index, state, true, discard});
+}
+
+void RenderGraph::PassBuilder::set_side_effect()
+{
+    m_graph.m_passes[m_pass_index].side_effect = true;
+}
+
+RenderGraph::RenderGraph(Device &device)
+    : m_device{device}
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+    release_transients();
+}
+
+void RenderGraph::reset()
+{
+    m_passes.clear();
+    m_resources.clear();
+    m_order.clear();
+    m_async_wait_stages = 0;
+    m_compiled = false;
+}
+
+RenderGraphHandle RenderGraph::import_image(const std::string &name, Image &image)
+{
+    Resource resource{};
+    resource.name = name;
+    resource.image = &image;
+    m_resources.push_back(resource);
+
+    return {static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+void RenderGraph::set_output(RenderGraphHandle handle, const ImageState &final_state)
+{
+    auto &resource = get_resource(handle);
+    if (resource.transient)
+    {
+        throw std::runtime_error("render graph output must be an imported image!");
+    }
+
+    resource.output = true;
+    resource.final_state = final_state;
+}
+
+void RenderGraph::add_pass(const std::string &name, RenderGraphQueue queue, const SetupFunction &setup, ExecuteFunction execute)
+{
+    Pass pass{};
+    pass.name = name;
+    pass.queue = queue;
+    pass.execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+
+    PassBuilder builder{*this, static_cast<uint32_t>(m_passes.size() - 1)};
+    setup(builder);
+
+    m_compiled = false;
+}
+
+void RenderGraph::compile()
+{
+    // 按声明顺序执行，临时图像在第一次写入之前不能读取
+    std::vector<bool> written(m_resources.size(), false);
+    for (const auto &pass : m_passes)
+    {
+        for (const auto &access : pass.accesses)
+        {
+            if (!access.write && m_resources[access.resource].transient && !written[access.resource])
+            {
+                throw std::runtime_error("render graph pass reads a transient image before it is written!");
+            }
+        }
+        for (const auto &access : pass.accesses)
+        {
+            if (access.write)
+            {
+                written[access.resource] = true;
+            }
+        }
+    }
+
+    cull_passes();
+
+    assign_queues();
+
+    compute_lifetimes();
+
+    allocate_transients();
+
+    m_compiled = true;
+}
+
+void RenderGraph::execute(CommandBuffer &graphics, CommandBuffer *async_compute)
+{
+    if (!m_compiled)
+    {
+        throw std::runtime_error("render graph must be compiled before execution!");
+    }
+
+    if (has_async_work() && async_compute == nullptr)
+    {
+        throw std::runtime_error("render graph has async compute passes but no compute command buffer!");
+    }
+
+    for (uint32_t position = 0; position < m_order.size(); ++position)
+    {
+        const auto &pass = m_passes[m_order[position]];
+        record_pass(position, pass.async ? *async_compute : graphics);
+    }
+
+    // 输出转换到图外需要的状态，例如呈现布局
+    BarrierBuilder barriers;
+    for (auto &resource : m_resources)
+    {
+        if (resource.output)
+        {
+            barriers.transition(*resource.image, resource.final_state, WHOLE_IMAGE);
+        }
+    }
+    barriers.record(graphics.get_handle());
+}
+
+bool RenderGraph::has_async_work() const
+{
+    for (auto pass_index : m_order)
+    {
+        if (m_passes[pass_index].async)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+VkPipelineStageFlags RenderGraph::get_async_wait_stages() const
+{
+    return m_async_wait_stages;
+}
+
+Image &RenderGraph::get_image(RenderGraphHandle handle)
+{
+    auto &resource = get_resource(handle);
+    if (resource.image == nullptr)
+    {
+        throw std::runtime_error("render graph image is not allocated, the passes using it were culled!");
+    }
+    return *resource.image;
+}
+
+std::vector<std::string> RenderGraph::get_execution_order() const
+{
+    std::vector<std::string> names;
+    names.reserve(m_order.size());
+    for (auto pass_index : m_order)
+    {
+        names.push_back(m_passes[pass_index].name);
+    }
+    return names;
+}
+
+void RenderGraph::cull_passes()
+{
+    // 从后往前：写入了被需要的资源的通道保留，它读取的资源在之前也被需要；
+    // 丢弃原有内容的写入之前的内容不再被需要，保留内容的写入(加载、混合)相当于先读取
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t i = 0; i < m_resources.size(); ++i)
+    {
+        needed[i] = m_resources[i].output;
+    }
+
+    for (auto it = m_passes.rbegin(); it != m_passes.rend(); ++it)
+    {
+        auto &pass = *it;
+
+        bool alive = pass.side_effect;
+        for (const auto &access : pass.accesses)
+        {
+            if (access.write && needed[access.resource])
+            {
+                alive = true;
+            }
+        }
+
+        pass.culled = !alive;
+        if (!alive)
+        {
+            continue;
+        }
+
+        for (const auto &access : pass.accesses)
+        {
+            if (access.write && access.discard)
+            {
+                needed[access.resource] = false;
+            }
+        }
+        // 临时图像的第一次写入之前没有写入者，保持needed不影响裁剪
+        for (const auto &access : pass.accesses)
+        {
+            if (!access.write || !access.discard)
+            {
+                needed[access.resource] = true;
+            }
+        }
+    }
+
+    m_order.clear();
+    for (uint32_t i = 0; i < m_passes.size(); ++i)
+    {
+        if (!m_passes[i].culled)
+        {
+            m_order.push_back(i);
+        }
+    }
+}
+
+void RenderGraph::assign_queues()
+{
+    for (auto pass_index : m_order)
+    {
+        auto &pass = m_passes[pass_index];
+        pass.async = pass.queue == RenderGraphQueue::AsyncCompute;
+    }
+
+    // 异步通道只能访问临时图像(并发共享，不需要队列族所有权转移)，
+    // 图形通道对这些图像只能在异步通道之后读取；不满足时退回图形队列，直到稳定
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t position = 0; position < m_order.size(); ++position)
+        {
+            auto &pass = m_passes[m_order[position]];
+            if (!pass.async)
+            {
+                continue;
+            }
+
+            bool allowed = true;
+            for (const auto &access : pass.accesses)
+            {
+                if (!m_resources[access.resource].transient)
+                {
+                    allowed = false;
+                }
+
+                for (size_t other = 0; other < m_order.size() && allowed; ++other)
+                {
+                    const auto &other_pass = m_passes[m_order[other]];
+                    if (other_pass.async)
+                    {
+                        continue;
+                    }
+
+                    for (const auto &other_access : other_pass.accesses)
+                    {
+                        if (other_access.resource != access.resource)
+                        {
+                            continue;
+                        }
+
+                        if (other_access.write || other < position)
+                        {
+                            allowed = false;
+                        }
+                    }
+                }
+            }
+
+            if (!allowed)
+            {
+                pass.async = false;
+                changed = true;
+            }
+        }
+    }
+
+    for (auto &resource : m_resources)
+    {
+        resource.async = false;
+    }
+    for (auto pass_index : m_order)
+    {
+        const auto &pass = m_passes[pass_index];
+        if (!pass.async)
+        {
+            continue;
+        }
+        for (const auto &access : pass.accesses)
+        {
+            m_resources[access.resource].async = true;
+        }
+    }
+
+    // 图形队列中读取异步结果的阶段需要等待异步提交
+    m_async_wait_stages = 0;
+    for (auto pass_index : m_order)
+    {
+        const auto &pass = m_passes[pass_index];
+        if (pass.async)
+        {
+            continue;
+        }
+        for (const auto &access : pass.accesses)
+        {
+            if (m_resources[access.resource].async)
+            {
+                m_async_wait_stages |= to_submit_stages(access.state.stage_mask);
+            }
+        }
+    }
+}
+
+void RenderGraph::compute_lifetimes()
+{
+    for (auto &resource : m_resources)
+    {
+        resource.first_use = UINT32_MAX;
+        resource.last_use = 0;
+    }
+
+    for (uint32_t position = 0; position < m_order.size(); ++position)
+    {
+        for (const auto &access : m_passes[m_order[position]].accesses)
+        {
+            auto &resource = m_resources[access.resource];
+            resource.first_use = std::min(resource.first_use, position);
+            resource.last_use = std::max(resource.last_use, position);
+        }
+    }
+}
+
+void RenderGraph::allocate_transients()
+{
+    // 只有被保留的通道用到的临时图像需要分配
+    std::vector<uint32_t> transients;
+    std::vector<TransientPlan> plan;
+    for (uint32_t i = 0; i < m_resources.size(); ++i)
+    {
+        const auto &resource = m_resources[i];
+        if (resource.transient && resource.first_use != UINT32_MAX)
+        {
+            transients.push_back(i);
+            plan.push_back({resource.desc, resource.first_use, resource.last_use, resource.async});
+        }
+    }
+
+    if (plan != m_plan)
+    {
+        release_transients();
+        m_plan = plan;
+
+        VkDevice device = m_device.get_handle();
+
+        // 异步资源在图形和计算队列族之间并发共享
+        std::set<uint32_t> families;
+        for (const auto &family : m_device.get_queues())
+        {
+            if (!family.empty() && (family[0].get_properties().queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+            {
+                families.insert(family[0].get_family_index());
+            }
+        }
+        std::vector<uint32_t> family_indices{families.begin(), families.end()};
+
+        std::vector<VkMemoryRequirements> requirements(plan.size());
+        for (size_t i = 0; i < plan.size(); ++i)
+        {
+            const auto &entry = plan[i];
+
+            VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+            image_info.imageType = VK_IMAGE_TYPE_2D;
+            image_info.format = entry.desc.format;
+            image_info.extent = {entry.desc.extent.width, entry.desc.extent.height, 1};
+            image_info.mipLevels = 1;
+            image_info.arrayLayers = 1;
+            image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+            image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+            image_info.usage = entry.desc.usage;
+            image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            if (entry.async && family_indices.size() > 1)
+            {
+                image_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+                image_info.queueFamilyIndexCount = static_cast<uint32_t>(family_indices.size());
+                image_info.pQueueFamilyIndices = family_indices.data();
+            }
+
+            PhysicalImage physical{};
+            if (vkCreateImage(device, &image_info, nullptr, &physical.handle) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create render graph image!");
+            }
+            vkGetImageMemoryRequirements(device, physical.handle, &requirements[i]);
+            m_physical_images.push_back(std::move(physical));
+        }
+
+        // 从大到小放入内存块，同一块中的图像生命周期互不重叠，都从偏移0开始
+        std::vector<uint32_t> by_size(plan.size());
+        for (uint32_t i = 0; i < by_size.size(); ++i)
+        {
+            by_size[i] = i;
+        }
+        std::stable_sort(by_size.begin(), by_size.end(), [&requirements](uint32_t a, uint32_t b)
+                         { return requirements[a].size > requirements[b].size; });
+
+        std::vector<VkMemoryRequirements> block_requirements;
+        std::vector<std::vector<uint32_t>> block_entries;
+        for (auto i : by_size)
+        {
+            const auto &entry = plan[i];
+            const auto &requirement = requirements[i];
+
+            uint32_t block = UINT32_MAX;
+            if (!entry.async)
+            {
+                for (uint32_t b = 0; b < block_entries.size() && block == UINT32_MAX; ++b)
+                {
+                    if ((block_requirements[b].memoryTypeBits & requirement.memoryTypeBits) == 0 || plan[block_entries[b][0]].async)
+                    {
+                        continue;
+                    }
+
+                    bool overlaps = false;
+                    for (auto other : block_entries[b])
+                    {
+                        if (!(plan[other].last_use < entry.first_use || entry.last_use < plan[other].first_use))
+                        {
+                            overlaps = true;
+                        }
+                    }
+                    if (!overlaps)
+                    {
+                        block = b;
+                    }
+                }
+            }
+
+            if (block == UINT32_MAX)
+            {
+                block_requirements.push_back(requirement);
+                block_entries.push_back({});
+                block = static_cast<uint32_t>(block_entries.size() - 1);
+            }
+            else
+            {
+                auto &block_requirement = block_requirements[block];
+                block_requirement.size = std::max(block_requirement.size, requirement.size);
+                block_requirement.alignment = std::max(block_requirement.alignment, requirement.alignment);
+                block_requirement.memoryTypeBits &= requirement.memoryTypeBits;
+            }
+
+            block_entries[block].push_back(i);
+            m_physical_images[i].block = block;
+        }
+
+        VmaAllocationCreateInfo allocation_info{};
+        allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        for (const auto &block_requirement : block_requirements)
+        {
+            VmaAllocation allocation{VK_NULL_HANDLE};
+            if (vmaAllocateMemory(m_device.get_memory_allocator(), &block_requirement, &allocation_info, &allocation, nullptr) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate render graph memory!");
+            }
+            m_memory_blocks.push_back(allocation);
+        }
+
+        for (size_t i = 0; i < plan.size(); ++i)
+        {
+            auto &physical = m_physical_images[i];
+            if (vmaBindImageMemory(m_device.get_memory_allocator(), m_memory_blocks[physical.block], physical.handle) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to bind render graph image memory!");
+            }
+
+            const auto &desc = plan[i].desc;
+            physical.image = std::make_unique<Image>(m_device, physical.handle, VkExtent3D{desc.extent.width, desc.extent.height, 1},
+                                                     desc.format, desc.usage);
+        }
+
+        spdlog::debug("render graph: {} transient images in {} memory blocks", plan.size(), m_memory_blocks.size());
+    }
+
+    // 同一块内存上按使用顺序排列，第一个的前驱是最后一个(上一帧最后的使用)
+    std::vector<std::vector<uint32_t>> block_entries(m_memory_blocks.size());
+    for (uint32_t i = 0; i < m_physical_images.size(); ++i)
+    {
+        block_entries[m_physical_images[i].block].push_back(i);
+    }
+    for (auto &entries : block_entries)
+    {
+        std::sort(entries.begin(), entries.end(), [&plan](uint32_t a, uint32_t b)
+                  { return plan[a].first_use < plan[b].first_use; });
+    }
+
+    for (uint32_t i = 0; i < transients.size(); ++i)
+    {
+        auto &resource = m_resources[transients[i]];
+        resource.physical = i;
+        resource.image = m_physical_images[i].image.get();
+
+        const auto &entries = block_entries[m_physical_images[i].block];
+        auto found = std::find(entries.begin(), entries.end(), i);
+        resource.alias_predecessor = found == entries.begin() ? entries.back() : *(found - 1);
+    }
+}
+
+void RenderGraph::release_transients()
+{
+    if (m_physical_images.empty() && m_memory_blocks.empty())
+    {
+        return;
+    }
+
+    // 之前的帧可能仍在使用，交给延迟删除队列
+    auto images = std::make_shared<std::vector<PhysicalImage>>(std::move(m_physical_images));
+    auto blocks = std::move(m_memory_blocks);
+    VkDevice device = m_device.get_handle();
+    VmaAllocator allocator = m_device.get_memory_allocator();
+    m_device.get_deletion_queue().push([device, allocator, images, blocks]()
+                                       {
+                                           for (auto &physical : *images)
+                                           {
+                                               physical.image.reset();
+                                               vkDestroyImage(device, physical.handle, nullptr);
+                                           }
+                                           for (auto block : blocks)
+                                           {
+                                               vmaFreeMemory(allocator, block);
+                                           } });
+
+    m_physical_images.clear();
+    m_memory_blocks.clear();
+    m_plan.clear();
+}
+
+void RenderGraph::record_pass(uint32_t position, CommandBuffer &command_buffer)
+{
+    auto &pass = m_passes[m_order[position]];
+
+    // 一个通道的所有转换合并为一次屏障
+    BarrierBuilder barriers;
+    std::vector<uint32_t> aliased;
+    for (const auto &access : pass.accesses)
+    {
+        auto &resource = m_resources[access.resource];
+        bool discard = access.discard;
+
+        if (resource.transient && position == resource.first_use &&
+            std::find(aliased.begin(), aliased.end(), access.resource) == aliased.end())
+        {
+            aliased.push_back(access.resource);
+
+            if (resource.async)
+            {
+                // 异步图像独占内存，上一帧图形队列的访问由提交时等待的信号量保证。
+                // 计算队列的屏障不能使用图形阶段，从所有命令开始与信号量等待衔接
+                resource.image->set_state(WHOLE_IMAGE, {VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, VK_ACCESS_2_NONE_KHR});
+            }
+            else
+            {
+                // 复用内存：等待同一块内存上前一个图像的访问完成，内容无需保留
+                const auto &predecessor = *m_physical_images[resource.alias_predecessor].image;
+                const auto &last = predecessor.get_state(0, 0);
+                resource.image->set_state(WHOLE_IMAGE, {VK_IMAGE_LAYOUT_UNDEFINED, last.stage_mask, last.access_mask});
+            }
+            discard = true;
+        }
+
+        barriers.transition(*resource.image, access.state, WHOLE_IMAGE, discard);
+    }
+    barriers.record(command_buffer.get_handle());
+
+    pass.execute(command_buffer, *this);
+}
+
+RenderGraph::Resource &RenderGraph::get_resource(RenderGraphHandle handle)
+{
+    if (!handle.is_valid() || handle.index >= m_resources.size())
+    {
+        throw std::runtime_error("invalid render graph handle!");
+    }
+    return m_resources[handle.index];
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "volk.h"
+#include "vk_mem_alloc.h"
+
+#include "comet/vulkan/device.h"
+#include "comet/vulkan/image.h"
+#include "comet/vulkan/command_buffer.h"
+
+namespace comet
+{
+    /// 渲染图中的虚拟资源，只在同一次构建(reset之后)内有效
+    struct RenderGraphHandle
+    {
+        uint32_t index{UINT32_MAX};
+
+        bool is_valid() const;
+    };
+
+    /// 由渲染图分配的临时图像，生命周期不重叠的临时图像共享内存
+    struct TransientImageDesc
+    {
+        VkExtent2D extent{};
+
+        VkFormat format{VK_FORMAT_UNDEFINED};
+
+        VkImageUsageFlags usage{0};
+
+        bool operator==(const TransientImageDesc &other) const;
+    };
+
+    enum class RenderGraphQueue
+    {
+        Graphics,
+        /// 尽量放到异步计算队列，依赖不满足时退回图形队列
+        AsyncCompute
+    };
+
+    /// 每帧重新声明通道及其读写的资源，compile后按声明顺序执行：
+    /// 裁剪结果不被使用的通道，每个通道之前合并成一次屏障，临时图像按生命周期复用内存
+    class RenderGraph
+    {
+    public:
+        class PassBuilder
+        {
+        public:
+            /// 声明一个由渲染图分配的临时图像，第一次访问必须是写入
+            RenderGraphHandle create(const std::string &name, const TransientImageDesc &desc);
+
+            /// 以state读取
+            void read(RenderGraphHandle handle, const ImageState &state);
+
+            /// 以state写入，discard为true时不保留原有内容(临时图像第一次写入总是丢弃)
+            void write(RenderGraphHandle handle, const ImageState &state, bool discard = false);
+
+            /// 有图外可见的副作用，不会被裁剪
+            void set_side_effect();
+
+        private:
+            friend class RenderGraph;
+
+            PassBuilder(RenderGraph &graph, uint32_t pass_index);
+
+            RenderGraph &m_graph;
+
+            uint32_t m_pass_index;
+        };
+
+        using SetupFunction = std::function<void(PassBuilder &builder)>;
+
+        using ExecuteFunction = std::function<void(CommandBuffer &command_buffer, RenderGraph &graph)>;
+
+    public:
+        explicit RenderGraph(Device &device);
+
+        RenderGraph(const RenderGraph &) = delete;
+
+        RenderGraph(RenderGraph &&) = delete;
+
+        /// 临时图像交给设备的延迟删除队列
+        ~RenderGraph();
+
+        RenderGraph &operator=(const RenderGraph &) = delete;
+
+        RenderGraph &operator=(RenderGraph &&) = delete;
+
+        /// 清除通道和资源声明，保留已分配的临时图像供下一次构建复用
+        void reset();
+
+        /// 引入外部图像，状态由Image自己跟踪
+        RenderGraphHandle import_image(const std::string &name, Image &image);
+
+        /// 标记为图的输出，执行结束后转换到final_state；只有输出和有副作用的通道会保留
+        void set_output(RenderGraphHandle handle, const ImageState &final_state);
+
+        void add_pass(const std::string &name, RenderGraphQueue queue, const SetupFunction &setup, ExecuteFunction execute);
+
+        /// 校验依赖、裁剪、分配队列和临时图像。声明与上一次相同时不会重新分配
+        void compile();
+
+        /// 按顺序录制通道。有异步计算工作时async_compute不能为空，
+        /// 它的提交需要等待图形队列上一次提交(上一帧可能仍在使用临时图像)，
+        /// 图形队列的提交需要在get_async_wait_stages()阶段等待它
+        void execute(CommandBuffer &graphics, CommandBuffer *async_compute = nullptr);
+
+        bool has_async_work() const;
+
+        /// 图形队列中使用异步计算结果的阶段，没有依赖时为0
+        VkPipelineStageFlags get_async_wait_stages() const;
+
+        /// 在执行函数中获取资源对应的图像
+        Image &get_image(RenderGraphHandle handle);
+
+        /// compile之后实际执行的通道名，按执行顺序
+        std::vector<std::string> get_execution_order() const;
+
+    private:
+        struct Access
+        {
+            uint32_t resource;
+
+            ImageState state;
+
+            bool write;
+
+            bool discard;
+        };
+
+        struct Pass
+        {
+            std::string name;
+
+            RenderGraphQueue queue;
+
+            std::vector<Access> accesses;
+
+            ExecuteFunction execute;
+
+            bool side_effect{false};
+
+            bool culled{false};
+
+            /// compile后实际使用异步计算队列
+            bool async{false};
+        };
+
+        struct Resource
+        {
+            std::string name;
+
+            /// 引入的外部图像，临时图像在compile后指向分配的图像
+            Image *image{nullptr};
+
+            bool transient{false};
+
+            TransientImageDesc desc{};
+
+            bool output{false};
+
+            ImageState final_state{};
+
+            /// 在执行顺序中第一次和最后一次使用的位置
+            uint32_t first_use{UINT32_MAX};
+
+            uint32_t last_use{0};
+
+            /// 被异步计算通道访问，不参与内存复用
+            bool async{false};
+
+            /// 分配的临时图像序号
+            uint32_t physical{UINT32_MAX};
+
+            /// 同一块内存上之前使用的资源，第一次写入前要等待它的访问完成
+            uint32_t alias_predecessor{UINT32_MAX};
+        };
+
+        /// 决定临时图像分配方式的全部信息，相同则复用已分配的图像
+        struct TransientPlan
+        {
+            TransientImageDesc desc;
+
+            uint32_t first_use;
+
+            uint32_t last_use;
+
+            bool async;
+
+            bool operator==(const TransientPlan &other) const;
+        };
+
+        struct PhysicalImage
+        {
+            VkImage handle{VK_NULL_HANDLE};
+
+            std::unique_ptr<Image> image;
+
+            uint32_t block;
+        };
+
+        void cull_passes();
+
+        void assign_queues();
+
+        void compute_lifetimes();
+
+        void allocate_transients();
+
+        void release_transients();
+
+        /// 录制执行顺序中position处的通道，之前先记录它需要的屏障
+        void record_pass(uint32_t position, CommandBuffer &command_buffer);
+
+        Resource &get_resource(RenderGraphHandle handle);
+
+    private:
+        Device &m_device;
+
+        std::vector<Pass> m_passes;
+
+        std::vector<Resource> m_resources;
+
+        /// 未被裁剪的通道，按执行顺序
+        std::vector<uint32_t> m_order;
+
+        VkPipelineStageFlags m_async_wait_stages{0};
+
+        bool m_compiled{false};
+
+        std::vector<TransientPlan> m_plan;
+
+        std::vector<PhysicalImage> m_physical_images;
+
+        std::vector<VmaAllocation> m_memory_blocks;
+    };
+} // namespace comet
@@ -0,0 +1,425 @@
+#include "comet/rendering/shader_compiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include "glslang/Public/ShaderLang.h"
+#include "glslang/Public/ResourceLimits.h"
+#include "SPIRV/GlslangToSpv.h"
+#include "spdlog/spdlog.h"
+
+#include "comet/core/hash.h"
+
+using namespace comet;
+
+namespace
+{
+const uint32_t CACHE_FILE_MAGIC = 0x43535043; // "CPSC"
+
+/// 缓存格式或编译选项变化时递增，旧的缓存自动失效
+const uint32_t CACHE_FILE_VERSION = 1;
+
+/// 缓存文件损坏时避免分配过大的字符串
+const uint32_t MAX_PATH_LENGTH = 4096;
+
+/// glslang的全局状态只需要初始化一次，最后一个编译器销毁时释放
+std::mutex process_mutex;
+
+uint32_t process_ref_count = 0;
+
+bool read_text(const std::filesystem::path &path, std::string &text)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    text = stream.str();
+    return true;
+}
+
+uint64_t hash_text(const std::string &text)
+{
+    return hash_bytes(text.data(), text.size());
+}
+
+EShLanguage to_language(VkShaderStageFlagBits stage)
+{
+    switch (stage)
+    {
+    case VK_SHADER_STAGE_VERTEX_BIT:
+        return EShLangVertex;
+    case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+        return EShLangTessControl;
+    case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+        return EShLangTessEvaluation;
+    case VK_SHADER_STAGE_GEOMETRY_BIT:
+        return EShLangGeometry;
+    case VK_SHADER_STAGE_FRAGMENT_BIT:
+        return EShLangFragment;
+    case VK_SHADER_STAGE_COMPUTE_BIT:
+        return EShLangCompute;
+    default:
+        throw std::runtime_error("unsupported shader stage!");
+    }
+}
+
+/// 解析#include，并记录每个被包含文件的路径和内容哈希
+class Includer : public glslang::TShader::Includer
+{
+public:
+    explicit Includer(const std::vector<std::filesystem::path> &include_directories)
+        : m_include_directories{include_directories}
+    {
+    }
+
+    IncludeResult *includeLocal(const char *header_name, const char *includer_name, size_t depth) override
+    {
+        // 先在包含者所在的目录查找
+        auto local_path = std::filesystem::path(includer_name).parent_path() / header_name;
+        if (auto *result = include(local_path))
+        {
+            return result;
+        }
+        return includeSystem(header_name, includer_name, depth);
+    }
+
+    IncludeResult *includeSystem(const char *header_name, const char *, size_t) override
+    {
+        for (const auto &directory : m_include_directories)
+        {
+            if (auto *result = include(directory / header_name))
+            {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    void releaseInclude(IncludeResult *result) override
+    {
+        if (result)
+        {
+            delete static_cast<std::string *>(result->userData);
+            delete result;
+        }
+    }
+
+    const std::vector<std::pair<std::filesystem::path, uint64_t>> &get_dependencies() const
+    {
+        return m_dependencies;
+    }
+
+private:
+    IncludeResult *include(const std::filesystem::path &path)
+    {
+        auto content = std::make_unique<std::string>();
+        if (!read_text(path, *content))
+        {
+            return nullptr;
+        }
+
+        auto normalized = path.lexically_normal();
+        auto found = std::find_if(m_dependencies.begin(), m_dependencies.end(), [&normalized](const auto &dependency)
+                                  { return dependency.first == normalized; });
+        if (found == m_dependencies.end())
+        {
+            m_dependencies.emplace_back(normalized, hash_text(*content));
+        }
+
+        // 名字会作为后续相对包含的includer_name
+        auto *result = new IncludeResult(normalized.string(), content->data(), content->size(), content.get());
+        content.release();
+        return result;
+    }
+
+private:
+    const std::vector<std::filesystem::path> &m_include_directories;
+
+    std::vector<std::pair<std::filesystem::path, uint64_t>> m_dependencies;
+};
+
+template <typename T>
+void write_value(std::ostream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_value(std::istream &stream, T &value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+} // namespace
+
+ShaderCompiler::ShaderCompiler(ThreadPool &thread_pool, const std::filesystem::path &cache_directory,
+                               const std::vector<std::filesystem::path> &include_directories)
+    : m_thread_pool{thread_pool}, m_cache_directory{cache_directory}, m_include_directories{include_directories}
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_cache_directory, error);
+    if (error)
+    {
+        spdlog::warn("failed to create shader cache directory {}: {}", m_cache_directory.string(), error.message());
+    }
+
+    std::lock_guard<std::mutex> lock(process_mutex);
+    if (process_ref_count++ == 0)
+    {
+        glslang::InitializeProcess();
+    }
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+    std::lock_guard<std::mutex> lock(process_mutex);
+    if (--process_ref_count == 0)
+    {
+        glslang::FinalizeProcess();
+    }
+}
+
+ShaderBinary ShaderCompiler::compile(const ShaderVariant &variant)
+{
+    auto cache_path = get_cache_path(variant);
+
+    ShaderBinary binary;
+    if (load_cache(cache_path, binary))
+    {
+        return binary;
+    }
+
+    std::vector<uint64_t> dependency_hashes;
+    binary = compile_glsl(variant, dependency_hashes);
+    save_cache(cache_path, binary, dependency_hashes);
+
+    return binary;
+}
+
+std::future<ShaderBinary> ShaderCompiler::compile_async(const ShaderVariant &variant)
+{
+    auto task = std::make_shared<std::packaged_task<ShaderBinary()>>([this, variant]()
+                                                                      { return compile(variant); });
+    auto future = task->get_future();
+
+    m_thread_pool.push([task](uint32_t)
+                       { (*task)(); });
+
+    return future;
+}
+
+VkShaderStageFlagBits ShaderCompiler::get_stage(const std::filesystem::path &path)
+{
+    auto extension = path.extension().string();
+    if (extension == ".vert")
+    {
+        return VK_SHADER_STAGE_VERTEX_BIT;
+    }
+    if (extension == ".tesc")
+    {
+        return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    }
+    if (extension == ".tese")
+    {
+        return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    }
+    if (extension == ".geom")
+    {
+        return VK_SHADER_STAGE_GEOMETRY_BIT;
+    }
+    if (extension == ".frag")
+    {
+        return VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    if (extension == ".comp")
+    {
+        return VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    throw std::runtime_error("unknown shader extension: " + extension);
+}
+
+std::filesystem::path ShaderCompiler::get_cache_path(const ShaderVariant &variant) const
+{
+    // 文件内容不在键里：缓存中记录了依赖的内容哈希，源文件改动后覆盖同一个缓存文件
+    auto path = variant.path.lexically_normal().string();
+    auto stage = static_cast<uint32_t>(variant.stage);
+
+    uint64_t key = hash_bytes(&CACHE_FILE_VERSION, sizeof(CACHE_FILE_VERSION));
+    key = hash_bytes(path.data(), path.size(), key);
+    key = hash_bytes(&stage, sizeof(stage), key);
+    key = hash_bytes(variant.entry_point.data(), variant.entry_point.size(), key);
+    for (const auto &[name, value] : variant.defines)
+    {
+        // 分隔符避免("AB", "")和("A", "B")得到相同的键
+        key = hash_bytes(name.data(), name.size() + 1, key);
+        key = hash_bytes(value.data(), value.size() + 1, key);
+    }
+
+    std::ostringstream file_name;
+    file_name << std::hex << std::setw(16) << std::setfill('0') << key << ".spv";
+    return m_cache_directory / file_name.str();
+}
+
+bool ShaderCompiler::load_cache(const std::filesystem::path &cache_path, ShaderBinary &binary) const
+{
+    std::ifstream file(cache_path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t dependency_count = 0;
+    if (!read_value(file, magic) || !read_value(file, version) || !read_value(file, dependency_count) ||
+        magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION)
+    {
+        return false;
+    }
+
+    binary.dependencies.clear();
+    for (uint32_t i = 0; i < dependency_count; ++i)
+    {
+        uint32_t path_length = 0;
+        if (!read_value(file, path_length) || path_length > MAX_PATH_LENGTH)
+        {
+            return false;
+        }
+
+        std::string path(path_length, '\0');
+        uint64_t hash = 0;
+        if (!file.read(path.data(), path_length) || !read_value(file, hash))
+        {
+            return false;
+        }
+
+        // 依赖被修改或删除，缓存失效
+        std::string text;
+        if (!read_text(path, text) || hash_text(text) != hash)
+        {
+            return false;
+        }
+
+        binary.dependencies.emplace_back(path);
+    }
+
+    uint32_t word_count = 0;
+    if (!read_value(file, word_count) || word_count == 0)
+    {
+        return false;
+    }
+
+    binary.spirv.resize(word_count);
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(binary.spirv.data()), word_count * sizeof(uint32_t)));
+}
+
+void ShaderCompiler::save_cache(const std::filesystem::path &cache_path, const ShaderBinary &binary,
+                                const std::vector<uint64_t> &dependency_hashes) const
+{
+    // 多个线程可能同时编译同一个排列，各自写临时文件再重命名
+    std::ostringstream temp_name;
+    temp_name << cache_path.filename().string() << ".tmp" << std::hash<std::thread::id>{}(std::this_thread::get_id());
+    auto temp_path = cache_path.parent_path() / temp_name.str();
+
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            spdlog::warn("failed to open {} for writing", temp_path.string());
+            return;
+        }
+
+        write_value(file, CACHE_FILE_MAGIC);
+        write_value(file, CACHE_FILE_VERSION);
+        write_value(file, static_cast<uint32_t>(binary.dependencies.size()));
+        for (size_t i = 0; i < binary.dependencies.size(); ++i)
+        {
+            // 记录编译时读到的内容，编译期间文件又被修改时下次会重新编译
+            auto path = binary.dependencies[i].string();
+            write_value(file, static_cast<uint32_t>(path.size()));
+            file.write(path.data(), path.size());
+            write_value(file, dependency_hashes[i]);
+        }
+        write_value(file, static_cast<uint32_t>(binary.spirv.size()));
+        file.write(reinterpret_cast<const char *>(binary.spirv.data()), binary.spirv.size() * sizeof(uint32_t));
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, cache_path, error);
+    if (error)
+    {
+        spdlog::warn("failed to write shader cache {}: {}", cache_path.string(), error.message());
+        std::filesystem::remove(temp_path, error);
+    }
+}
+
+ShaderBinary ShaderCompiler::compile_glsl(const ShaderVariant &variant, std::vector<uint64_t> &dependency_hashes) const
+{
+    auto path = variant.path.lexically_normal();
+    auto name = path.string();
+
+    std::string source;
+    if (!read_text(path, source))
+    {
+        throw std::runtime_error("failed to open shader file " + name + "!");
+    }
+
+    std::string preamble;
+    for (const auto &[define, value] : variant.defines)
+    {
+        preamble += "#define " + define + " " + value + "\n";
+    }
+
+    auto language = to_language(variant.stage);
+
+    glslang::TShader shader(language);
+    const char *source_text = source.c_str();
+    const char *source_name = name.c_str();
+    shader.setStringsWithLengthsAndNames(&source_text, nullptr, &source_name, 1);
+    shader.setPreamble(preamble.c_str());
+    shader.setEntryPoint(variant.entry_point.c_str());
+    shader.setSourceEntryPoint(variant.entry_point.c_str());
+    shader.setEnvInput(glslang::EShSourceGlsl, language, glslang::EShClientVulkan, 100);
+    shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
+    shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_5);
+
+    auto messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+
+    Includer includer(m_include_directories);
+    if (!shader.parse(GetDefaultResources(), 100, false, messages, includer))
+    {
+        throw std::runtime_error("failed to compile shader " + name + "!\n" + shader.getInfoLog());
+    }
+
+    glslang::TProgram program;
+    program.addShader(&shader);
+    if (!program.link(messages))
+    {
+        throw std::runtime_error("failed to link shader " + name + "!\n" + program.getInfoLog());
+    }
+
+    ShaderBinary binary;
+    glslang::SpvOptions options{};
+    glslang::GlslangToSpv(*program.getIntermediate(language), binary.spirv, &options);
+
+    binary.dependencies.push_back(path);
+    dependency_hashes.push_back(hash_text(source));
+    for (const auto &[dependency, hash] : includer.get_dependencies())
+    {
+        binary.dependencies.push_back(dependency);
+        dependency_hashes.push_back(hash);
+    }
+
+    return binary;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/core/thread_pool.h"
+
+namespace comet
+{
+    /// 一个着色器排列：同一源文件配合不同的宏得到不同的SPIR-V
+    struct ShaderVariant
+    {
+        std::filesystem::path path;
+
+        VkShaderStageFlagBits stage{VK_SHADER_STAGE_VERTEX_BIT};
+
+        /// 按顺序写成#define name value
+        std::vector<std::pair<std::string, std::string>> defines;
+
+        std::string entry_point{"main"};
+    };
+
+    struct ShaderBinary
+    {
+        std::vector<uint32_t> spirv;
+
+        /// 源文件和它直接或间接包含的所有文件，任意一个变化都需要重新编译
+        std::vector<std::filesystem::path> dependencies;
+    };
+
+    /// 进程内用glslang把GLSL编译为SPIR-V，支持宏和#include。
+    /// 结果按源文件路径、阶段、入口和宏的哈希缓存到磁盘，缓存中记录所有依赖文件的内容哈希，
+    /// 源文件或被包含的文件改动后自动重新编译。可以在多个线程同时调用
+    class ShaderCompiler
+    {
+    public:
+        /// include_directories用于#include <...>，以及在包含者所在目录找不到的#include "..."
+        ShaderCompiler(ThreadPool &thread_pool, const std::filesystem::path &cache_directory,
+                       const std::vector<std::filesystem::path> &include_directories = {});
+
+        ShaderCompiler(const ShaderCompiler &) = delete;
+
+        ShaderCompiler(ShaderCompiler &&) = delete;
+
+        ~ShaderCompiler();
+
+        ShaderCompiler &operator=(const ShaderCompiler &) = delete;
+
+        ShaderCompiler &operator=(ShaderCompiler &&) = delete;
+
+        /// 在当前线程编译，缓存有效时直接读取；编译失败时异常中带有glslang的日志
+        ShaderBinary compile(const ShaderVariant &variant);
+
+        /// 在线程池中编译，异常在future.get()时重新抛出
+        std::future<ShaderBinary> compile_async(const ShaderVariant &variant);
+
+        /// 按扩展名(.vert/.tesc/.tese/.geom/.frag/.comp)推断阶段
+        static VkShaderStageFlagBits get_stage(const std::filesystem::path &path);
+
+    private:
+        std::filesystem::path get_cache_path(const ShaderVariant &variant) const;
+
+        bool load_cache(const std::filesystem::path &cache_path, ShaderBinary &binary) const;
+
+        /// dependency_hashes与binary.dependencies一一对应
+        void save_cache(const std::filesystem::path &cache_path, const ShaderBinary &binary,
+                        const std::vector<uint64_t> &dependency_hashes) const;
+
+        ShaderBinary compile_glsl(const ShaderVariant &variant, std::vector<uint64_t> &dependency_hashes) const;
+
+    private:
+        ThreadPool &m_thread_pool;
+
+        std::filesystem::path m_cache_directory;
+
+        std::vector<std::filesystem::path> m_include_directories;
+    };
+} // namespace comet
@@ -0,0 +1,144 @@
+#include "comet/rendering/skyline_packer.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace comet;
+
+SkylinePacker::SkylinePacker(uint32_t width, uint32_t height)
+    : m_width(width), m_height(height)
+{
+    reset();
+}
+
+bool SkylinePacker::insert(uint32_t width, uint32_t height, uint32_t &x, uint32_t &y)
+{
+    if (width == 0 || height == 0 || width > m_width || height > m_height)
+    {
+        return false;
+    }
+
+    size_t best_index = m_nodes.size();
+    uint32_t best_top = std::numeric_limits<uint32_t>::max();
+    uint32_t best_width = std::numeric_limits<uint32_t>::max();
+    uint32_t best_y = 0;
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        uint32_t node_y;
+        if (!fit(i, width, height, node_y))
+        {
+            continue;
+        }
+
+        uint32_t top = node_y + height;
+        if (top < best_top || (top == best_top && m_nodes[i].width < best_width))
+        {
+            best_index = i;
+            best_top = top;
+            best_width = m_nodes[i].width;
+            best_y = node_y;
+        }
+    }
+
+    if (best_index == m_nodes.size())
+    {
+        return false;
+    }
+
+    x = m_nodes[best_index].x;
+    y = best_y;
+
+    add_node(best_index, x, y, width, height);
+    m_used_area += static_cast<uint64_t>(width) * height;
+
+    return true;
+}
+
+void SkylinePacker::reset()
+{
+    m_nodes.clear();
+    m_nodes.push_back({0, 0, m_width});
+    m_used_area = 0;
+}
+
+uint32_t SkylinePacker::get_width() const
+{
+    return m_width;
+}
+
+uint32_t SkylinePacker::get_height() const
+{
+    return m_height;
+}
+
+float SkylinePacker::get_occupancy() const
+{
+    return static_cast<float>(m_used_area) / (static_cast<float>(m_width) * static_cast<float>(m_height));
+}
+
+bool SkylinePacker::fit(size_t index, uint32_t width, uint32_t height, uint32_t &y) const
+{
+    uint32_t x = m_nodes[index].x;
+    if (x + width > m_width)
+    {
+        return false;
+    }
+
+    // 矩形覆盖的所有线段中最高的那个决定放置高度
+    int64_t width_left = width;
+    y = m_nodes[index].y;
+    while (width_left > 0)
+    {
+        y = std::max(y, m_nodes[index].y);
+        if (y + height > m_height)
+        {
+            return false;
+        }
+
+        width_left -= m_nodes[index].width;
+        ++index;
+    }
+
+    return true;
+}
+
+void SkylinePacker::add_node(size_t index, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    m_nodes.insert(m_nodes.begin() + index, {x, y + height, width});
+
+    // 裁剪被新线段覆盖的后续线段
+    for (size_t i = index + 1; i < m_nodes.size();)
+    {
+        auto &previous = m_nodes[i - 1];
+        auto &node = m_nodes[i];
+
+        if (node.x >= previous.x + previous.width)
+        {
+            break;
+        }
+
+        uint32_t shrink = previous.x + previous.width - node.x;
+        if (node.width <= shrink)
+        {
+            m_nodes.erase(m_nodes.begin() + i);
+            continue;
+        }
+
+        node.x += shrink;
+        node.width -= shrink;
+        break;
+    }
+
+    // 合并高度相同的相邻线段
+    for (size_t i = 0; i + 1 < m_nodes.size();)
+    {
+        if (m_nodes[i].y == m_nodes[i + 1].y)
+        {
+            m_nodes[i].width += m_nodes[i + 1].width;
+            m_nodes.erase(m_nodes.begin() + i + 1);
+            continue;
+        }
+        ++i;
+    }
+}
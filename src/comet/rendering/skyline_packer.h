@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace comet
+{
+    /// skyline装箱：维护一条由水平线段组成的"天际线"，
+    /// 新矩形放在使其顶部最低的位置（bottom-left），相同时选浪费宽度最小的线段
+    class SkylinePacker
+    {
+    public:
+        SkylinePacker(uint32_t width, uint32_t height);
+
+        /// 成功时返回true并写出左上角坐标
+        bool insert(uint32_t width, uint32_t height, uint32_t &x, uint32_t &y);
+
+        void reset();
+
+        uint32_t get_width() const;
+
+        uint32_t get_height() const;
+
+        /// 已占用面积比例
+        float get_occupancy() const;
+
+    private:
+        struct Node
+        {
+            uint32_t x;
+
+            uint32_t y;
+
+            uint32_t width;
+        };
+
+        /// 从第index个线段开始放置width x height的矩形，返回可放置的y；放不下返回false
+        bool fit(size_t index, uint32_t width, uint32_t height, uint32_t &y) const;
+
+        void add_node(size_t index, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+    private:
+        uint32_t m_width;
+
+        uint32_t m_height;
+
+        uint64_t m_used_area{0};
+
+        std::vector<Node> m_nodes;
+    };
+} // namespace comet
@@ -0,0 +1,96 @@
+#include "comet/rendering/static_command_cache.h"
+
+#include "comet/core/hash.h"
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+StaticCommandCache::StaticCommandCache(Device &device, uint32_t queue_family_index)
+    : m_device{device}, m_queue_family_index{queue_family_index}
+{
+}
+
+StaticCommandCache::~StaticCommandCache()
+{
+    clear();
+}
+
+CommandBuffer &StaticCommandCache::request(const std::string &name, size_t content_hash,
+                                           const VkCommandBufferInheritanceInfo &inheritance,
+                                           const RecordFunction &record_function)
+{
+    // 帧缓冲或渲染通道变化后旧命令缓冲不能再在新的渲染通道中执行
+    size_t hash = content_hash;
+    hash_combine(hash, inheritance.renderPass);
+    hash_combine(hash, inheritance.subpass);
+    hash_combine(hash, inheritance.framebuffer);
+
+    // 动态渲染没有渲染通道，附件格式在继承信息的pNext中
+    auto rendering = static_cast<const VkCommandBufferInheritanceRenderingInfoKHR *>(inheritance.pNext);
+    if (rendering && rendering->sType == VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR)
+    {
+        for (uint32_t i = 0; i < rendering->colorAttachmentCount; ++i)
+        {
+            hash_combine(hash, static_cast<uint32_t>(rendering->pColorAttachmentFormats[i]));
+        }
+        hash_combine(hash, static_cast<uint32_t>(rendering->depthAttachmentFormat));
+        hash_combine(hash, static_cast<uint32_t>(rendering->rasterizationSamples));
+    }
+
+    auto &entry = m_entries[name];
+    if (entry.command_buffer && entry.hash == hash)
+    {
+        return *entry.command_buffer;
+    }
+
+    // 旧的命令缓冲可能仍被飞行中的帧引用，不能原地重置
+    retire(entry);
+
+    // 每个条目独占一个命令池，重新录制时整体替换
+    entry.command_pool = std::make_unique<CommandPool>(m_device, m_queue_family_index, 0, 0);
+    entry.command_buffer = &entry.command_pool->request_command_buffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    entry.hash = hash;
+
+    entry.command_buffer->begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritance);
+    record_function(*entry.command_buffer);
+    entry.command_buffer->end();
+
+    m_record_count++;
+
+    return *entry.command_buffer;
+}
+
+void StaticCommandCache::invalidate(const std::string &name)
+{
+    auto found = m_entries.find(name);
+    if (found != m_entries.end())
+    {
+        retire(found->second);
+        m_entries.erase(found);
+    }
+}
+
+void StaticCommandCache::clear()
+{
+    for (auto &[name, entry] : m_entries)
+    {
+        retire(entry);
+    }
+    m_entries.clear();
+}
+
+size_t StaticCommandCache::size() const
+{
+    return m_entries.size();
+}
+
+uint64_t StaticCommandCache::get_record_count() const
+{
+    return m_record_count;
+}
+
+void StaticCommandCache::retire(Entry &entry)
+{
+    entry.command_buffer = nullptr;
+    m_device.get_deletion_queue().retire(std::move(entry.command_pool));
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "volk.h"
+
+#include "comet/vulkan/command_buffer.h"
+#include "comet/vulkan/command_pool.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 缓存内容很少变化的通道(UI、静态几何)的次级命令缓冲。
+    /// 录制时不带ONE_TIME_SUBMIT，内容哈希和继承信息不变时直接复用，
+    /// 变化时旧的命令缓冲交给设备的延迟删除队列，正在执行的帧不受影响
+    class StaticCommandCache
+    {
+    public:
+        using RecordFunction = std::function<void(CommandBuffer &command_buffer)>;
+
+    public:
+        StaticCommandCache(Device &device, uint32_t queue_family_index);
+
+        StaticCommandCache(const StaticCommandCache &) = delete;
+
+        StaticCommandCache(StaticCommandCache &&) = delete;
+
+        ~StaticCommandCache();
+
+        StaticCommandCache &operator=(const StaticCommandCache &) = delete;
+
+        StaticCommandCache &operator=(StaticCommandCache &&) = delete;
+
+        /// 返回name对应的次级命令缓冲，content_hash需要覆盖record_function用到的全部输入
+        /// (管线、缓冲、视口等)，它或inheritance的渲染通道、帧缓冲变化时重新录制。
+        /// 命令缓冲会被多个飞行中的帧同时执行，录制时带SIMULTANEOUS_USE
+        CommandBuffer &request(const std::string &name, size_t content_hash,
+                               const VkCommandBufferInheritanceInfo &inheritance,
+                               const RecordFunction &record_function);
+
+        /// 下一次request时强制重新录制
+        void invalidate(const std::string &name);
+
+        /// 移除全部条目，例如交换链重建后帧缓冲都已失效
+        void clear();
+
+        size_t size() const;
+
+        /// 累计录制次数，静态内容稳定后不再增长
+        uint64_t get_record_count() const;
+
+    private:
+        struct Entry
+        {
+            std::unique_ptr<CommandPool> command_pool;
+
+            CommandBuffer *command_buffer{nullptr};
+
+            size_t hash{0};
+        };
+
+        void retire(Entry &entry);
+
+    private:
+        Device &m_device;
+
+        uint32_t m_queue_family_index;
+
+        std::unordered_map<std::string, Entry> m_entries;
+
+        uint64_t m_record_count{0};
+    };
+} // namespace comet
@@ -0,0 +1,198 @@
+#include "comet/rendering/texture_atlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "comet/vulkan/barrier.h"
+#include "comet/vulkan/common.h"
+
+using namespace comet;
+
+TextureAtlas::TextureAtlas(Device &device, VkFormat format, VkExtent2D layer_extent, uint32_t max_layers, uint32_t padding)
+    : m_device{device},
+      m_format{format},
+      m_layer_extent{layer_extent},
+      m_max_layers{max_layers},
+      m_padding{padding},
+      m_texel_size{get_format_texel_size(format)}
+{
+    if (max_layers == 0)
+    {
+        throw std::runtime_error("texture atlas needs at least one layer!");
+    }
+
+    m_image = std::make_unique<Image>(device,
+                                      VkExtent3D{layer_extent.width, layer_extent.height, 1},
+                                      format,
+                                      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                      VMA_MEMORY_USAGE_GPU_ONLY,
+                                      VK_SAMPLE_COUNT_1_BIT,
+                                      1,
+                                      max_layers);
+}
+
+std::optional<AtlasRegion> TextureAtlas::insert(uint32_t width, uint32_t height, const void *pixels)
+{
+    uint32_t padded_width = width + 2 * m_padding;
+    uint32_t padded_height = height + 2 * m_padding;
+    if (width == 0 || height == 0 || padded_width > m_layer_extent.width || padded_height > m_layer_extent.height)
+    {
+        return std::nullopt;
+    }
+
+    // 依次尝试已有的层，都放不下再开新层
+    uint32_t layer = 0;
+    uint32_t x = 0, y = 0;
+    for (; layer < m_max_layers; ++layer)
+    {
+        if (layer == m_packers.size())
+        {
+            m_packers.push_back(std::make_unique<SkylinePacker>(m_layer_extent.width, m_layer_extent.height));
+        }
+
+        if (m_packers[layer]->insert(padded_width, padded_height, x, y))
+        {
+            break;
+        }
+    }
+
+    if (layer == m_max_layers)
+    {
+        return std::nullopt;
+    }
+
+    // 四周复制边缘像素作为padding，避免线性过滤时采样到相邻区域
+    PendingUpload upload{};
+    upload.layer = layer;
+    upload.offset = {static_cast<int32_t>(x), static_cast<int32_t>(y)};
+    upload.extent = {padded_width, padded_height};
+    upload.data.resize(static_cast<size_t>(padded_width) * padded_height * m_texel_size);
+
+    auto src = static_cast<const uint8_t *>(pixels);
+    for (uint32_t row = 0; row < padded_height; ++row)
+    {
+        uint32_t src_row = std::min(std::max(row, m_padding) - m_padding, height - 1);
+        for (uint32_t col = 0; col < padded_width; ++col)
+        {
+            uint32_t src_col = std::min(std::max(col, m_padding) - m_padding, width - 1);
+            std::memcpy(upload.data.data() + (static_cast<size_t>(row) * padded_width + col) * m_texel_size,
+                        src + (static_cast<size_t>(src_row) * width + src_col) * m_texel_size,
+                        m_texel_size);
+        }
+    }
+    m_pending.push_back(std::move(upload));
+
+    AtlasRegion region{};
+    region.layer = layer;
+    region.x = x + m_padding;
+    region.y = y + m_padding;
+    region.width = width;
+    region.height = height;
+    region.uv_offset = {static_cast<float>(region.x) / m_layer_extent.width, static_cast<float>(region.y) / m_layer_extent.height};
+    region.uv_scale = {static_cast<float>(width) / m_layer_extent.width, static_cast<float>(height) / m_layer_extent.height};
+
+    return region;
+}
+
+bool TextureAtlas::has_pending_uploads() const
+{
+    return !m_pending.empty();
+}
+
+std::unique_ptr<Buffer> TextureAtlas::flush(VkCommandBuffer command_buffer)
+{
+    if (m_pending.empty())
+    {
+        return nullptr;
+    }
+
+    VkDeviceSize total_size = 0;
+    for (const auto &upload : m_pending)
+    {
+        total_size += upload.data.size();
+    }
+
+    auto staging = std::make_unique<Buffer>(m_device, total_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+
+    // 所有区域写入同一个暂存缓冲，只转换有新数据的层
+    std::vector<VkBufferImageCopy> regions;
+    regions.reserve(m_pending.size());
+    BarrierBuilder barriers;
+    VkDeviceSize offset = 0;
+    for (const auto &upload : m_pending)
+    {
+        staging->update(upload.data.data(), upload.data.size(), offset);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, upload.layer, 1};
+        region.imageOffset = {upload.offset.x, upload.offset.y, 0};
+        region.imageExtent = {upload.extent.width, upload.extent.height, 1};
+        regions.push_back(region);
+
+        // 从未上传过的层没有需要保留的内容
+        VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, upload.layer, 1};
+        bool discard = m_image->get_state(0, upload.layer).layout == VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers.transition(*m_image,
+                            {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR},
+                            range,
+                            discard);
+
+        offset += upload.data.size();
+    }
+    barriers.record(command_buffer);
+
+    vkCmdCopyBufferToImage(command_buffer,
+                           staging->get_handle(),
+                           m_image->get_handle(),
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()),
+                           regions.data());
+
+    for (const auto &upload : m_pending)
+    {
+        VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, upload.layer, 1};
+        barriers.transition(*m_image,
+                            {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                             VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR},
+                            range);
+    }
+
+    // 第一次上传时其余的层仍是未定义布局，一起转换，整个图像的视图都可以采样
+    for (uint32_t layer = 0; layer < m_max_layers; ++layer)
+    {
+        if (m_image->get_state(0, layer).layout == VK_IMAGE_LAYOUT_UNDEFINED)
+        {
+            VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, layer, 1};
+            barriers.transition(*m_image,
+                                {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                 VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                                 VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR},
+                                range,
+                                true);
+        }
+    }
+    barriers.record(command_buffer);
+
+    m_pending.clear();
+
+    return staging;
+}
+
+void TextureAtlas::clear()
+{
+    m_packers.clear();
+    m_pending.clear();
+}
+
+Image &TextureAtlas::get_image() const
+{
+    return *m_image;
+}
+
+uint32_t TextureAtlas::get_layer_count() const
+{
+    return static_cast<uint32_t>(m_packers.size());
+}
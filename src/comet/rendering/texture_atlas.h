@@ -0,0 +1,100 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "volk.h"
+#include "glm/glm.hpp"
+
+#include "comet/rendering/skyline_packer.h"
+#include "comet/vulkan/buffer.h"
+#include "comet/vulkan/device.h"
+#include "comet/vulkan/image.h"
+
+namespace comet
+{
+    /// 图集中的一块区域，uv = uv_offset + uv * uv_scale
+    struct AtlasRegion
+    {
+        uint32_t layer;
+
+        uint32_t x;
+
+        uint32_t y;
+
+        uint32_t width;
+
+        uint32_t height;
+
+        glm::vec2 uv_offset;
+
+        glm::vec2 uv_scale;
+    };
+
+    /// 把大量小纹理打包进一张2D array图像，每层一个skyline装箱器。
+    /// 插入只写入CPU端，flush时把所有新区域一次性上传
+    class TextureAtlas
+    {
+    public:
+        TextureAtlas(Device &device, VkFormat format, VkExtent2D layer_extent, uint32_t max_layers, uint32_t padding = 1);
+
+        TextureAtlas(const TextureAtlas &) = delete;
+
+        TextureAtlas(TextureAtlas &&) = delete;
+
+        ~TextureAtlas() = default;
+
+        TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+        TextureAtlas &operator=(TextureAtlas &&) = delete;
+
+        /// pixels为紧密排列的width x height像素，所有层都放不下时返回空
+        std::optional<AtlasRegion> insert(uint32_t width, uint32_t height, const void *pixels);
+
+        bool has_pending_uploads() const;
+
+        /// 记录所有待上传区域的拷贝，之后所有层(包括还没有使用的)都处于SHADER_READ_ONLY_OPTIMAL。
+        /// 返回的暂存缓冲需要保持到命令执行完成，可以在提交后交给DeletionQueue::retire
+        std::unique_ptr<Buffer> flush(VkCommandBuffer command_buffer);
+
+        /// 清空所有层的装箱状态，已有区域失效
+        void clear();
+
+        Image &get_image() const;
+
+        uint32_t get_layer_count() const;
+
+    private:
+        struct PendingUpload
+        {
+            uint32_t layer;
+
+            VkOffset2D offset;
+
+            VkExtent2D extent;
+
+            /// 包含padding边缘的像素
+            std::vector<uint8_t> data;
+        };
+
+        Device &m_device;
+
+        VkFormat m_format;
+
+        VkExtent2D m_layer_extent;
+
+        uint32_t m_max_layers;
+
+        uint32_t m_padding;
+
+        uint32_t m_texel_size;
+
+        std::unique_ptr<Image> m_image;
+
+        /// 按需创建，数量即已使用的层数
+        std::vector<std::unique_ptr<SkylinePacker>> m_packers;
+
+        std::vector<PendingUpload> m_pending;
+    };
+} // namespace comet
@@ -0,0 +1,226 @@
+#include "comet/rendering/upscaler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "comet/rendering/pipeline_registry.h"
+#include "comet/vulkan/device.h"
+#include "comet/vulkan/shader_reflection.h"
+
+using namespace comet;
+
+Upscaler::Upscaler(Device &device, ResourceCache &resource_cache, VkPipelineCache pipeline_cache,
+                   const std::vector<uint32_t> &vertex_spirv, const std::vector<uint32_t> &fragment_spirv,
+                   VkFormat target_format, bool dynamic_rendering)
+    : m_device{device}, m_resource_cache{resource_cache}, m_target_format{target_format}
+{
+    if (dynamic_rendering && !m_device.is_dynamic_rendering_enabled())
+    {
+        throw std::runtime_error("dynamic rendering is not enabled on the device!");
+    }
+
+    ShaderReflection reflection(vertex_spirv);
+    reflection.merge(ShaderReflection(fragment_spirv));
+    if (reflection.get_set_count() != 1 || reflection.get_set_layout_bindings(0).size() != 1 ||
+        reflection.get_bindings().front().type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+    {
+        throw std::runtime_error("upscale shaders must use a single combined image sampler!");
+    }
+    m_pipeline_layout = m_resource_cache.request_pipeline_layout(reflection);
+
+    // 渲染区域之外的内容由着色器限制纹理坐标避开
+    VkSamplerCreateInfo sampler_info{};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_LINEAR;
+    sampler_info.minFilter = VK_FILTER_LINEAR;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.maxLod = 0.0f;
+    m_sampler = m_resource_cache.request_sampler(sampler_info);
+
+    if (!dynamic_rendering)
+    {
+        // 全屏三角形覆盖每个像素，不需要加载原有内容；布局转换由调用者完成
+        RenderPassAttachment attachment{};
+        attachment.format = m_target_format;
+        attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        attachment.load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.store_op = VK_ATTACHMENT_STORE_OP_STORE;
+        attachment.initial_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachment.final_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        RenderPassDesc render_pass_desc{};
+        render_pass_desc.color_attachments = {attachment};
+        m_render_pass = m_resource_cache.request_render_pass(render_pass_desc);
+    }
+
+    GraphicsPipelineDesc desc{};
+    desc.shaders = {{VK_SHADER_STAGE_VERTEX_BIT, vertex_spirv},
+                    {VK_SHADER_STAGE_FRAGMENT_BIT, fragment_spirv}};
+    desc.cull_mode = VK_CULL_MODE_NONE;
+
+    VkPipelineColorBlendAttachmentState blend_attachment{};
+    blend_attachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    desc.blend_attachments = {blend_attachment};
+
+    desc.layout = m_pipeline_layout;
+    desc.render_pass = m_render_pass;
+    desc.color_formats = {m_target_format};
+    m_pipeline = PipelineRegistry::create_graphics_pipeline(m_device, pipeline_cache, desc);
+}
+
+Upscaler::~Upscaler()
+{
+    auto &deletion_queue = m_device.get_deletion_queue();
+
+    VkDevice device = m_device.get_handle();
+    VkPipeline pipeline = m_pipeline;
+    deletion_queue.push([device, pipeline]()
+                        { vkDestroyPipeline(device, pipeline, nullptr); });
+
+    deletion_queue.retire(std::move(m_descriptor_pool));
+    for (auto &framebuffer : m_framebuffers)
+    {
+        deletion_queue.retire(std::move(framebuffer));
+    }
+}
+
+void Upscaler::set_sharpness(float sharpness)
+{
+    m_sharpness = std::clamp(sharpness, 0.0f, 1.0f);
+}
+
+float Upscaler::get_sharpness() const
+{
+    return m_sharpness;
+}
+
+void Upscaler::set_source(const std::shared_ptr<ImageView> &source)
+{
+    // 之前录制的命令可能仍在使用旧的描述符集
+    m_device.get_deletion_queue().retire(std::move(m_descriptor_pool));
+    m_descriptor_set = VK_NULL_HANDLE;
+    m_source = source;
+    if (!m_source)
+    {
+        return;
+    }
+
+    m_descriptor_pool = std::make_unique<DescriptorPool>(m_device, 1, std::vector<VkDescriptorPoolSize>{{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1}});
+    m_descriptor_set = m_descriptor_pool->allocate(*m_pipeline_layout->get_set_layouts().front());
+
+    DescriptorWriter writer;
+    writer.write_image(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, *m_source, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_sampler->get_handle());
+    writer.update(m_device, m_descriptor_set);
+}
+
+void Upscaler::set_targets(const std::vector<std::shared_ptr<ImageView>> &targets)
+{
+    auto &deletion_queue = m_device.get_deletion_queue();
+    for (auto &framebuffer : m_framebuffers)
+    {
+        deletion_queue.retire(std::move(framebuffer));
+    }
+    m_framebuffers.clear();
+
+    for (const auto &target : targets)
+    {
+        if (target->get_format() != m_target_format)
+        {
+            throw std::runtime_error("upscale target format does not match the pipeline!");
+        }
+    }
+    m_targets = targets;
+
+    if (m_render_pass)
+    {
+        for (const auto &target : m_targets)
+        {
+            const auto &extent = target->get_image().get_extent();
+            m_framebuffers.push_back(m_resource_cache.request_framebuffer(m_render_pass, {target}, {extent.width, extent.height}));
+        }
+    }
+}
+
+void Upscaler::record(VkCommandBuffer command_buffer, const VkExtent2D &source_extent, uint32_t target_index) const
+{
+    if (!m_source || target_index >= m_targets.size())
+    {
+        throw std::runtime_error("upscaler source or target not set!");
+    }
+
+    const auto &target_image_extent = m_targets[target_index]->get_image().get_extent();
+    VkExtent2D target_extent{target_image_extent.width, target_image_extent.height};
+    const auto &source_image_extent = m_source->get_image().get_extent();
+    float source_width = static_cast<float>(source_image_extent.width);
+    float source_height = static_cast<float>(source_image_extent.height);
+
+    PushConstants push_constants{};
+    push_constants.uv_scale[0] = source_extent.width / source_width;
+    push_constants.uv_scale[1] = source_extent.height / source_height;
+    push_constants.uv_step[0] = push_constants.uv_scale[0] / target_extent.width;
+    push_constants.uv_step[1] = push_constants.uv_scale[1] / target_extent.height;
+    push_constants.uv_max[0] = (source_extent.width - 0.5f) / source_width;
+    push_constants.uv_max[1] = (source_extent.height - 0.5f) / source_height;
+    push_constants.sharpness = m_sharpness;
+
+    if (m_render_pass)
+    {
+        VkRenderPassBeginInfo render_pass_info{};
+        render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        render_pass_info.renderPass = m_render_pass->get_handle();
+        render_pass_info.framebuffer = m_framebuffers[target_index]->get_handle();
+        render_pass_info.renderArea.extent = target_extent;
+        vkCmdBeginRenderPass(command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
+    }
+    else
+    {
+        VkRenderingAttachmentInfoKHR color_attachment{};
+        color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        color_attachment.imageView = m_targets[target_index]->get_handle();
+        color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+        VkRenderingInfoKHR rendering_info{};
+        rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+        rendering_info.renderArea.extent = target_extent;
+        rendering_info.layerCount = 1;
+        rendering_info.colorAttachmentCount = 1;
+        rendering_info.pColorAttachments = &color_attachment;
+        vkCmdBeginRenderingKHR(command_buffer, &rendering_info);
+    }
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+
+    VkViewport viewport{0.0f, 0.0f, static_cast<float>(target_extent.width), static_cast<float>(target_extent.height), 0.0f, 1.0f};
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+    VkRect2D scissor{{0, 0}, target_extent};
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline_layout->get_handle(), 0, 1, &m_descriptor_set, 0, nullptr);
+    vkCmdPushConstants(command_buffer, m_pipeline_layout->get_handle(), VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(push_constants), &push_constants);
+    vkCmdDraw(command_buffer, 3, 1, 0, 0);
+
+    if (m_render_pass)
+    {
+        vkCmdEndRenderPass(command_buffer);
+    }
+    else
+    {
+        vkCmdEndRenderingKHR(command_buffer);
+    }
+}
+
+ImageState Upscaler::get_source_state()
+{
+    return {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR};
+}
+
+ImageState Upscaler::get_target_state()
+{
+    return {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR};
+}
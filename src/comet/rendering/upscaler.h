@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/descriptor_pool.h"
+#include "comet/vulkan/framebuffer.h"
+#include "comet/vulkan/image.h"
+#include "comet/vulkan/image_view.h"
+#include "comet/vulkan/pipeline_layout.h"
+#include "comet/vulkan/render_pass.h"
+#include "comet/vulkan/resource_cache.h"
+#include "comet/vulkan/sampler.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 把动态分辨率的场景拉伸到输出图像：双线性采样后做对比度自适应锐化(RCAS)，补回拉伸损失的细节。
+    /// 一个全屏三角形以颜色附件写入输出，交换链图像不需要支持存储用途。
+    /// 使用动态渲染时直接渲染到视图，否则使用缓存中的渲染通道和帧缓冲
+    class Upscaler
+    {
+    public:
+        /// 着色器的资源接口：set 0 binding 0是场景的组合图像采样器，推送常量与PushConstants一致。
+        /// dynamic_rendering为false时使用渲染通道，为true时设备需要开启动态渲染
+        Upscaler(Device &device, ResourceCache &resource_cache, VkPipelineCache pipeline_cache,
+                 const std::vector<uint32_t> &vertex_spirv, const std::vector<uint32_t> &fragment_spirv,
+                 VkFormat target_format, bool dynamic_rendering);
+
+        Upscaler(const Upscaler &) = delete;
+
+        Upscaler(Upscaler &&) = delete;
+
+        /// 管线和描述符交给设备的延迟删除队列
+        ~Upscaler();
+
+        Upscaler &operator=(const Upscaler &) = delete;
+
+        Upscaler &operator=(Upscaler &&) = delete;
+
+        /// 0只做双线性拉伸，1最强
+        void set_sharpness(float sharpness);
+
+        float get_sharpness() const;
+
+        /// 场景图像重新分配后调用，旧的描述符等之前的帧完成后销毁
+        void set_source(const std::shared_ptr<ImageView> &source);
+
+        /// 交换链重建后调用，格式需要与构造时一致
+        void set_targets(const std::vector<std::shared_ptr<ImageView>> &targets);
+
+        /// 把source左上角source_extent的区域拉伸到整个targets[target_index]。
+        /// 之前source需处于get_source_state()，target需处于get_target_state()
+        void record(VkCommandBuffer command_buffer, const VkExtent2D &source_extent, uint32_t target_index) const;
+
+        static ImageState get_source_state();
+
+        static ImageState get_target_state();
+
+    private:
+        struct PushConstants
+        {
+            float uv_scale[2];
+
+            float uv_step[2];
+
+            float uv_max[2];
+
+            float sharpness;
+        };
+
+    private:
+        Device &m_device;
+
+        ResourceCache &m_resource_cache;
+
+        VkFormat m_target_format;
+
+        float m_sharpness{0.5f};
+
+        std::shared_ptr<PipelineLayout> m_pipeline_layout;
+
+        std::shared_ptr<Sampler> m_sampler;
+
+        /// 动态渲染时为空
+        std::shared_ptr<RenderPass> m_render_pass;
+
+        VkPipeline m_pipeline{VK_NULL_HANDLE};
+
+        std::shared_ptr<ImageView> m_source;
+
+        /// 每个场景视图一个池，不需要更新可能仍在使用的描述符集
+        std::unique_ptr<DescriptorPool> m_descriptor_pool;
+
+        VkDescriptorSet m_descriptor_set{VK_NULL_HANDLE};
+
+        std::vector<std::shared_ptr<ImageView>> m_targets;
+
+        /// 与m_targets一一对应，动态渲染时为空
+        std::vector<std::shared_ptr<Framebuffer>> m_framebuffers;
+    };
+} // namespace comet
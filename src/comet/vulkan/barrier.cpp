@@ -0,0 +1,252 @@
+#include "comet/vulkan/barrier.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+#include "comet/vulkan/common.h"
+
+using namespace comet;
+
+namespace
+{
+inline auto barrier_key(const VkImageMemoryBarrier2KHR &barrier)
+{
+    return std::make_tuple(barrier.image, barrier.oldLayout, barrier.newLayout,
+                           barrier.srcStageMask, barrier.srcAccessMask,
+                           barrier.dstStageMask, barrier.dstAccessMask);
+}
+} // namespace
+
+BarrierBuilder &BarrierBuilder::transition(Image &image, const ImageState &state, const VkImageSubresourceRange &range, bool discard)
+{
+    auto resolved = image.resolve_range(range);
+    auto &pending = m_pending[&image];
+
+    for (uint32_t layer = resolved.baseArrayLayer; layer < resolved.baseArrayLayer + resolved.layerCount; ++layer)
+    {
+        for (uint32_t mip = resolved.baseMipLevel; mip < resolved.baseMipLevel + resolved.levelCount; ++mip)
+        {
+            // 复制一份，下面会更新图像中的状态
+            const auto current = image.get_state(mip, layer);
+            auto subresource = layer * image.get_mip_levels() + mip;
+
+            // 同一批次内重复请求：屏障尚未记录，只能合并目标阶段
+            auto found = pending.find(subresource);
+            if (found != pending.end())
+            {
+                auto &transition = m_transitions[found->second];
+                if (transition.new_state.layout != state.layout)
+                {
+                    throw std::runtime_error("conflicting image layouts requested in one barrier batch!");
+                }
+
+                transition.new_state.stage_mask |= state.stage_mask;
+                transition.new_state.access_mask |= state.access_mask;
+
+                ImageState merged = current;
+                merged.stage_mask |= state.stage_mask;
+                merged.access_mask |= state.access_mask;
+                if (is_write_access(state.access_mask))
+                {
+                    merged.write_stage_mask = transition.new_state.stage_mask;
+                    merged.write_access_mask = transition.new_state.access_mask;
+                }
+                image.set_state(mip, layer, merged);
+                continue;
+            }
+
+            bool layout_change = discard || current.layout != state.layout;
+            bool src_write = is_write_access(current.access_mask);
+            bool dst_write = is_write_access(state.access_mask);
+
+            // 之前没有任何访问：不需要屏障
+            if (!layout_change && current.stage_mask == VK_PIPELINE_STAGE_2_NONE_KHR)
+            {
+                ImageState next = state;
+                next.write_stage_mask = dst_write ? state.stage_mask : VK_PIPELINE_STAGE_2_NONE_KHR;
+                next.write_access_mask = dst_write ? state.access_mask : VK_ACCESS_2_NONE_KHR;
+                image.set_state(mip, layer, next);
+                continue;
+            }
+
+            Transition transition{};
+            transition.image = &image;
+            transition.mip_level = mip;
+            transition.array_layer = layer;
+            transition.old_layout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : current.layout;
+            transition.new_state = state;
+
+            ImageState next = state;
+            if (!layout_change && !src_write && !dst_write)
+            {
+                // 读后读且布局不变：累积读取阶段，保证之后的写入会等待所有读取完成。
+                // 上一次写入只对已同步的读取可见，新的阶段或访问需要从写入建立依赖
+                next = current;
+                next.stage_mask |= state.stage_mask;
+                next.access_mask |= state.access_mask;
+                image.set_state(mip, layer, next);
+
+                bool covered = (state.stage_mask & ~current.stage_mask) == 0 && (state.access_mask & ~current.access_mask) == 0;
+                if (covered || current.write_stage_mask == VK_PIPELINE_STAGE_2_NONE_KHR)
+                {
+                    continue;
+                }
+
+                transition.src_stage_mask = current.write_stage_mask;
+                transition.src_access_mask = current.write_access_mask;
+            }
+            else
+            {
+                transition.src_stage_mask = current.stage_mask;
+                // 写后读/写后写需要让之前的写入可用；读后写只需要执行依赖
+                transition.src_access_mask = src_write ? current.access_mask : VK_ACCESS_2_NONE_KHR;
+
+                if (dst_write)
+                {
+                    next.write_stage_mask = state.stage_mask;
+                    next.write_access_mask = state.access_mask;
+                }
+                else if (layout_change)
+                {
+                    // 布局转换在屏障中完成并对目标阶段可见，之后的读取从目标阶段建立执行依赖
+                    next.write_stage_mask = state.stage_mask;
+                    next.write_access_mask = VK_ACCESS_2_NONE_KHR;
+                }
+                else
+                {
+                    next.write_stage_mask = current.write_stage_mask;
+                    next.write_access_mask = current.write_access_mask;
+                }
+                image.set_state(mip, layer, next);
+            }
+
+            pending[subresource] = m_transitions.size();
+            m_transitions.push_back(transition);
+        }
+    }
+
+    return *this;
+}
+
+BarrierBuilder &BarrierBuilder::buffer(const Buffer &buffer,
+                                       VkPipelineStageFlags2KHR src_stage_mask, VkAccessFlags2KHR src_access_mask,
+                                       VkPipelineStageFlags2KHR dst_stage_mask, VkAccessFlags2KHR dst_access_mask,
+                                       VkDeviceSize offset, VkDeviceSize size)
+{
+    VkBufferMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR};
+    barrier.srcStageMask = src_stage_mask;
+    // 读后写只需要执行依赖
+    barrier.srcAccessMask = is_write_access(src_access_mask) ? src_access_mask : VK_ACCESS_2_NONE_KHR;
+    barrier.dstStageMask = dst_stage_mask;
+    barrier.dstAccessMask = dst_access_mask;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer.get_handle();
+    barrier.offset = offset;
+    barrier.size = size;
+    m_buffer_barriers.push_back(barrier);
+
+    return *this;
+}
+
+bool BarrierBuilder::empty() const
+{
+    return m_transitions.empty() && m_buffer_barriers.empty();
+}
+
+std::vector<VkImageMemoryBarrier2KHR> BarrierBuilder::build() const
+{
+    // 每个子资源一个屏障
+    std::vector<VkImageMemoryBarrier2KHR> barriers;
+    barriers.reserve(m_transitions.size());
+    for (const auto &transition : m_transitions)
+    {
+        VkImageMemoryBarrier2KHR barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+        barrier.srcStageMask = transition.src_stage_mask;
+        barrier.srcAccessMask = transition.src_access_mask;
+        barrier.dstStageMask = transition.new_state.stage_mask;
+        barrier.dstAccessMask = transition.new_state.access_mask;
+        barrier.oldLayout = transition.old_layout;
+        barrier.newLayout = transition.new_state.layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = transition.image->get_handle();
+        barrier.subresourceRange = {transition.image->get_aspect_mask(), transition.mip_level, 1, transition.array_layer, 1};
+        barriers.push_back(barrier);
+    }
+
+    // 第一步：同一layer内连续的mip合并
+    std::sort(barriers.begin(), barriers.end(), [](const VkImageMemoryBarrier2KHR &a, const VkImageMemoryBarrier2KHR &b)
+              { return std::make_tuple(barrier_key(a), a.subresourceRange.baseArrayLayer, a.subresourceRange.baseMipLevel) <
+                       std::make_tuple(barrier_key(b), b.subresourceRange.baseArrayLayer, b.subresourceRange.baseMipLevel); });
+
+    std::vector<VkImageMemoryBarrier2KHR> mip_merged;
+    for (const auto &barrier : barriers)
+    {
+        if (!mip_merged.empty())
+        {
+            auto &last = mip_merged.back();
+            if (barrier_key(last) == barrier_key(barrier) &&
+                last.subresourceRange.baseArrayLayer == barrier.subresourceRange.baseArrayLayer &&
+                last.subresourceRange.baseMipLevel + last.subresourceRange.levelCount == barrier.subresourceRange.baseMipLevel)
+            {
+                last.subresourceRange.levelCount++;
+                continue;
+            }
+        }
+        mip_merged.push_back(barrier);
+    }
+
+    // 第二步：mip范围相同且连续的layer合并
+    std::sort(mip_merged.begin(), mip_merged.end(), [](const VkImageMemoryBarrier2KHR &a, const VkImageMemoryBarrier2KHR &b)
+              { return std::make_tuple(barrier_key(a), a.subresourceRange.baseMipLevel, a.subresourceRange.levelCount, a.subresourceRange.baseArrayLayer) <
+                       std::make_tuple(barrier_key(b), b.subresourceRange.baseMipLevel, b.subresourceRange.levelCount, b.subresourceRange.baseArrayLayer); });
+
+    std::vector<VkImageMemoryBarrier2KHR> merged;
+    for (const auto &barrier : mip_merged)
+    {
+        if (!merged.empty())
+        {
+            auto &last = merged.back();
+            if (barrier_key(last) == barrier_key(barrier) &&
+                last.subresourceRange.baseMipLevel == barrier.subresourceRange.baseMipLevel &&
+                last.subresourceRange.levelCount == barrier.subresourceRange.levelCount &&
+                last.subresourceRange.baseArrayLayer + last.subresourceRange.layerCount == barrier.subresourceRange.baseArrayLayer)
+            {
+                last.subresourceRange.layerCount++;
+                continue;
+            }
+        }
+        merged.push_back(barrier);
+    }
+
+    return merged;
+}
+
+void BarrierBuilder::record(VkCommandBuffer command_buffer)
+{
+    if (empty())
+    {
+        return;
+    }
+
+    auto barriers = build();
+
+    VkDependencyInfoKHR dependency_info{VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR};
+    dependency_info.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+    dependency_info.pImageMemoryBarriers = barriers.data();
+    dependency_info.bufferMemoryBarrierCount = static_cast<uint32_t>(m_buffer_barriers.size());
+    dependency_info.pBufferMemoryBarriers = m_buffer_barriers.data();
+
+    vkCmdPipelineBarrier2KHR(command_buffer, &dependency_info);
+
+    clear();
+}
+
+void BarrierBuilder::clear()
+{
+    m_transitions.clear();
+    m_buffer_barriers.clear();
+    m_pending.clear();
+}
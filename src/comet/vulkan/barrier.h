@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "volk.h"
+
+#include "comet/vulkan/buffer.h"
+#include "comet/vulkan/image.h"
+
+namespace comet
+{
+    /// 收集一批图像状态转换，根据Image记录的子资源状态只生成确实需要的屏障，
+    /// 并在record时合并为一次vkCmdPipelineBarrier2KHR。缓冲不跟踪状态，屏障由调用者给出
+    class BarrierBuilder
+    {
+    public:
+        BarrierBuilder() = default;
+
+        BarrierBuilder(const BarrierBuilder &) = delete;
+
+        BarrierBuilder(BarrierBuilder &&) = default;
+
+        ~BarrierBuilder() = default;
+
+        BarrierBuilder &operator=(const BarrierBuilder &) = delete;
+
+        BarrierBuilder &operator=(BarrierBuilder &&) = default;
+
+        /// 请求将image的range转换到state，discard为true时不保留原有内容
+        BarrierBuilder &transition(Image &image, const ImageState &state,
+                                   const VkImageSubresourceRange &range = {0, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS},
+                                   bool discard = false);
+
+        /// 计算着色器写入后作为间接参数、顶点或其他着色器的输入读取时使用
+        BarrierBuilder &buffer(const Buffer &buffer,
+                               VkPipelineStageFlags2KHR src_stage_mask, VkAccessFlags2KHR src_access_mask,
+                               VkPipelineStageFlags2KHR dst_stage_mask, VkAccessFlags2KHR dst_access_mask,
+                               VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+        bool empty() const;
+
+        /// 合并相邻的mip/layer，生成最终的屏障列表
+        std::vector<VkImageMemoryBarrier2KHR> build() const;
+
+        /// 记录所有待处理的屏障并清空
+        void record(VkCommandBuffer command_buffer);
+
+        void clear();
+
+    private:
+        struct Transition
+        {
+            Image *image;
+
+            uint32_t mip_level;
+
+            uint32_t array_layer;
+
+            VkImageLayout old_layout;
+
+            VkPipelineStageFlags2KHR src_stage_mask;
+
+            VkAccessFlags2KHR src_access_mask;
+
+            ImageState new_state;
+        };
+
+        std::vector<Transition> m_transitions;
+
+        std::vector<VkBufferMemoryBarrier2KHR> m_buffer_barriers;
+
+        /// 每个图像中已有待处理屏障的子资源，用于合并同一批次内的重复请求
+        std::unordered_map<const Image *, std::unordered_map<uint32_t, size_t>> m_pending;
+    };
+} // namespace comet
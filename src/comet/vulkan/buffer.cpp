@@ -0,0 +1,91 @@
+#include "comet/vulkan/buffer.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+Buffer::Buffer(const Device &device, VkDeviceSize size, VkBufferUsageFlags buffer_usage, VmaMemoryUsage memory_usage, VmaAllocationCreateFlags flags)
+    : m_device(device), m_size(size)
+{
+    VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    buffer_info.size = size;
+    buffer_info.usage = buffer_usage;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // CPU可写的缓冲持久映射，避免每次更新都调用vmaMapMemory
+    bool host_visible = memory_usage == VMA_MEMORY_USAGE_CPU_ONLY ||
+                        memory_usage == VMA_MEMORY_USAGE_CPU_TO_GPU ||
+                        memory_usage == VMA_MEMORY_USAGE_GPU_TO_CPU;
+
+    VmaAllocationCreateInfo memory_info{};
+    memory_info.flags = flags;
+    memory_info.usage = memory_usage;
+    if (host_visible)
+    {
+        memory_info.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    }
+
+    VmaAllocationInfo allocation_info{};
+    if (vmaCreateBuffer(m_device.get_memory_allocator(), &buffer_info, &memory_info, &m_handle, &m_memory, &allocation_info) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create buffer!");
+    }
+
+    m_mapped_data = static_cast<uint8_t *>(allocation_info.pMappedData);
+}
+
+Buffer::Buffer(Buffer &&other)
+    : m_device(other.m_device), m_handle(other.m_handle), m_memory(other.m_memory), m_size(other.m_size), m_mapped_data(other.m_mapped_data)
+{
+    other.m_handle = VK_NULL_HANDLE;
+    other.m_memory = VK_NULL_HANDLE;
+    other.m_mapped_data = nullptr;
+}
+
+Buffer::~Buffer()
+{
+    if (m_handle != VK_NULL_HANDLE && m_memory != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(m_device.get_memory_allocator(), m_handle, m_memory);
+    }
+}
+
+const Device &Buffer::get_device() const
+{
+    return m_device;
+}
+
+VkBuffer Buffer::get_handle() const
+{
+    return m_handle;
+}
+
+VkDeviceSize Buffer::get_size() const
+{
+    return m_size;
+}
+
+uint8_t *Buffer::get_data() const
+{
+    return m_mapped_data;
+}
+
+void Buffer::update(const void *data, VkDeviceSize size, VkDeviceSize offset)
+{
+    if (m_mapped_data == nullptr)
+    {
+        throw std::runtime_error("buffer is not host visible!");
+    }
+
+    std::memcpy(m_mapped_data + offset, data, size);
+
+    flush(offset, size);
+}
+
+void Buffer::flush(VkDeviceSize offset, VkDeviceSize size)
+{
+    vmaFlushAllocation(m_device.get_memory_allocator(), m_memory, offset, size);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "volk.h"
+#include "vk_mem_alloc.h"
+
+namespace comet
+{
+    class Device;
+
+    class Buffer
+    {
+    public:
+        Buffer(const Device &device,
+               VkDeviceSize size,
+               VkBufferUsageFlags buffer_usage,
+               VmaMemoryUsage memory_usage,
+               VmaAllocationCreateFlags flags = 0);
+
+        Buffer(const Buffer &) = delete;
+
+        Buffer(Buffer &&other);
+
+        ~Buffer();
+
+        Buffer &operator=(const Buffer &) = delete;
+
+        Buffer &operator=(Buffer &&) = delete;
+
+        const Device &get_device() const;
+
+        VkBuffer get_handle() const;
+
+        VkDeviceSize get_size() const;
+
+        /// CPU可见的缓冲会被持久映射，其余情况返回nullptr
+        uint8_t *get_data() const;
+
+        /// 拷贝数据到映射的内存并刷新
+        void update(const void *data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+        void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    private:
+        const Device &m_device;
+
+        VkBuffer m_handle{VK_NULL_HANDLE};
+
+        VmaAllocation m_memory{VK_NULL_HANDLE};
+
+        VkDeviceSize m_size{0};
+
+        uint8_t *m_mapped_data{nullptr};
+    };
+} // namespace comet
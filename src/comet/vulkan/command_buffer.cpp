@@ -0,0 +1,116 @@
+#include "comet/vulkan/command_buffer.h"
+
+#include <stdexcept>
+
+#include "comet/vulkan/command_pool.h"
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level)
+    : m_command_pool{command_pool}, m_level{level}
+{
+    VkCommandBufferAllocateInfo alloc_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    alloc_info.commandPool = m_command_pool.get_handle();
+    alloc_info.level = level;
+    alloc_info.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(m_command_pool.get_device().get_handle(), &alloc_info, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate command buffer!");
+    }
+}
+
+CommandBuffer::~CommandBuffer()
+{
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        vkFreeCommandBuffers(m_command_pool.get_device().get_handle(), m_command_pool.get_handle(), 1, &m_handle);
+    }
+}
+
+void CommandBuffer::begin(VkCommandBufferUsageFlags flags, const VkCommandBufferInheritanceInfo *inheritance_info)
+{
+    // 命令池没有RESET_COMMAND_BUFFER标志，不能对已记录的缓冲再次begin
+    if (m_state != State::Initial)
+    {
+        throw std::runtime_error("command buffer must be reset with its pool before recording again!");
+    }
+
+    if (m_level == VK_COMMAND_BUFFER_LEVEL_SECONDARY && inheritance_info == nullptr)
+    {
+        throw std::runtime_error("secondary command buffer requires inheritance info!");
+    }
+
+    VkCommandBufferBeginInfo begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    begin_info.flags = flags;
+    begin_info.pInheritanceInfo = inheritance_info;
+    if (vkBeginCommandBuffer(m_handle, &begin_info) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording command buffer!");
+    }
+
+    m_state = State::Recording;
+}
+
+void CommandBuffer::end()
+{
+    if (m_state != State::Recording)
+    {
+        throw std::runtime_error("command buffer is not recording!");
+    }
+
+    if (vkEndCommandBuffer(m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record command buffer!");
+    }
+
+    m_state = State::Executable;
+}
+
+void CommandBuffer::execute_commands(const CommandBuffer &secondary)
+{
+    VkCommandBuffer handle = secondary.get_handle();
+    vkCmdExecuteCommands(m_handle, 1, &handle);
+}
+
+void CommandBuffer::execute_commands(const std::vector<CommandBuffer *> &secondaries)
+{
+    if (secondaries.empty())
+    {
+        return;
+    }
+
+    std::vector<VkCommandBuffer> handles;
+    handles.reserve(secondaries.size());
+    for (auto *secondary : secondaries)
+    {
+        handles.push_back(secondary->get_handle());
+    }
+
+    vkCmdExecuteCommands(m_handle, static_cast<uint32_t>(handles.size()), handles.data());
+}
+
+VkCommandBuffer CommandBuffer::get_handle() const
+{
+    return m_handle;
+}
+
+VkCommandBufferLevel CommandBuffer::get_level() const
+{
+    return m_level;
+}
+
+CommandBuffer::State CommandBuffer::get_state() const
+{
+    return m_state;
+}
+
+CommandPool &CommandBuffer::get_command_pool()
+{
+    return m_command_pool;
+}
+
+void CommandBuffer::on_pool_reset()
+{
+    m_state = State::Initial;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+#include "volk.h"
+
+namespace comet
+{
+    class CommandPool;
+
+    /// 从CommandPool分配的命令缓冲，生命周期由命令池管理，
+    /// 不单独重置，命令池整体重置后可以直接重新begin
+    class CommandBuffer
+    {
+    public:
+        enum class State
+        {
+            Initial,
+            Recording,
+            Executable
+        };
+
+    public:
+        CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level);
+
+        CommandBuffer(const CommandBuffer &) = delete;
+
+        CommandBuffer(CommandBuffer &&) = delete;
+
+        ~CommandBuffer();
+
+        CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+        CommandBuffer &operator=(CommandBuffer &&) = delete;
+
+        /// 次级命令缓冲需要inheritance_info
+        void begin(VkCommandBufferUsageFlags flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                   const VkCommandBufferInheritanceInfo *inheritance_info = nullptr);
+
+        void end();
+
+        /// 执行次级命令缓冲
+        void execute_commands(const CommandBuffer &secondary);
+
+        /// 按顺序执行一组次级命令缓冲
+        void execute_commands(const std::vector<CommandBuffer *> &secondaries);
+
+        VkCommandBuffer get_handle() const;
+
+        VkCommandBufferLevel get_level() const;
+
+        State get_state() const;
+
+        CommandPool &get_command_pool();
+
+    private:
+        friend class CommandPool;
+
+        /// 命令池重置后由CommandPool调用
+        void on_pool_reset();
+
+    private:
+        CommandPool &m_command_pool;
+
+        VkCommandBuffer m_handle{VK_NULL_HANDLE};
+
+        VkCommandBufferLevel m_level;
+
+        State m_state{State::Initial};
+    };
+} // namespace comet
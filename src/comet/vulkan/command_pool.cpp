@@ -0,0 +1,85 @@
+#include "comet/vulkan/command_pool.h"
+
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+CommandPool::CommandPool(Device &device, uint32_t queue_family_index, uint32_t thread_index, VkCommandPoolCreateFlags flags)
+    : m_device{device}, m_queue_family_index{queue_family_index}, m_thread_index{thread_index}
+{
+    // 只整体重置，不需要RESET_COMMAND_BUFFER
+    VkCommandPoolCreateInfo create_info{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    create_info.flags = flags;
+    create_info.queueFamilyIndex = queue_family_index;
+    if (vkCreateCommandPool(m_device.get_handle(), &create_info, nullptr, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create command pool!");
+    }
+}
+
+CommandPool::~CommandPool()
+{
+    // 命令缓冲要在命令池之前释放
+    m_primary_command_buffers.clear();
+    m_secondary_command_buffers.clear();
+
+    vkDestroyCommandPool(m_device.get_handle(), m_handle, nullptr);
+}
+
+CommandBuffer &CommandPool::request_command_buffer(VkCommandBufferLevel level)
+{
+    auto &command_buffers = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? m_primary_command_buffers : m_secondary_command_buffers;
+    auto &active_count = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? m_active_primary_count : m_active_secondary_count;
+
+    if (active_count < command_buffers.size())
+    {
+        return *command_buffers[active_count++];
+    }
+
+    command_buffers.push_back(std::make_unique<CommandBuffer>(*this, level));
+    active_count++;
+
+    return *command_buffers.back();
+}
+
+void CommandPool::reset()
+{
+    if (vkResetCommandPool(m_device.get_handle(), m_handle, 0) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to reset command pool!");
+    }
+
+    for (auto &command_buffer : m_primary_command_buffers)
+    {
+        command_buffer->on_pool_reset();
+    }
+    for (auto &command_buffer : m_secondary_command_buffers)
+    {
+        command_buffer->on_pool_reset();
+    }
+
+    m_active_primary_count = 0;
+    m_active_secondary_count = 0;
+}
+
+Device &CommandPool::get_device()
+{
+    return m_device;
+}
+
+VkCommandPool CommandPool::get_handle() const
+{
+    return m_handle;
+}
+
+uint32_t CommandPool::get_queue_family_index() const
+{
+    return m_queue_family_index;
+}
+
+uint32_t CommandPool::get_thread_index() const
+{
+    return m_thread_index;
+}
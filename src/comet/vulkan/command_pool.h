@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/command_buffer.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 单个线程在单个帧内使用的命令池。命令缓冲只能整体重置，
+    /// 重置后已分配的命令缓冲按顺序被再次请求，不会重复分配。
+    /// 命令池不是线程安全的，每个录制线程需要独立的CommandPool
+    class CommandPool
+    {
+    public:
+        /// 每帧重新录制的命令池使用TRANSIENT，长期复用的命令缓冲传入0
+        CommandPool(Device &device, uint32_t queue_family_index, uint32_t thread_index = 0,
+                    VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+        CommandPool(const CommandPool &) = delete;
+
+        CommandPool(CommandPool &&) = delete;
+
+        ~CommandPool();
+
+        CommandPool &operator=(const CommandPool &) = delete;
+
+        CommandPool &operator=(CommandPool &&) = delete;
+
+        /// 返回一个处于初始状态的命令缓冲，优先复用重置后的缓冲
+        CommandBuffer &request_command_buffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+        /// 用vkResetCommandPool一次重置所有命令缓冲，调用前GPU必须已经执行完毕
+        void reset();
+
+        Device &get_device();
+
+        VkCommandPool get_handle() const;
+
+        uint32_t get_queue_family_index() const;
+
+        uint32_t get_thread_index() const;
+
+    private:
+        Device &m_device;
+
+        VkCommandPool m_handle{VK_NULL_HANDLE};
+
+        uint32_t m_queue_family_index;
+
+        uint32_t m_thread_index;
+
+        std::vector<std::unique_ptr<CommandBuffer>> m_primary_command_buffers;
+
+        /// 本次重置以来已经请求出去的主命令缓冲数量
+        uint32_t m_active_primary_count{0};
+
+        std::vector<std::unique_ptr<CommandBuffer>> m_secondary_command_buffers;
+
+        uint32_t m_active_secondary_count{0};
+    };
+} // namespace comet
@@ -1,5 +1,7 @@
 #include "comet/vulkan/common.h"
 
+#include <stdexcept>
+
 namespace comet
 {
 
@@ -21,4 +23,42 @@ bool is_depth_format(VkFormat format)
     return is_depth_only_format(format) || is_depth_stencil_format(format);
 }
 
+bool is_write_access(VkAccessFlags2KHR access_mask)
+{
+    const VkAccessFlags2KHR write_mask = VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+                                         VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR |
+                                         VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+                                         VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+                                         VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR |
+                                         VK_ACCESS_2_HOST_WRITE_BIT_KHR |
+                                         VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+
+    return (access_mask & write_mask) != 0;
+}
+
+uint32_t get_format_texel_size(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8_UNORM:
+        return 1;
+    case VK_FORMAT_R8G8_UNORM:
+        return 2;
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_R32_SFLOAT:
+    case VK_FORMAT_R32_UINT:
+        return 4;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+    case VK_FORMAT_R32G32_SFLOAT:
+        return 8;
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+        return 16;
+    default:
+        throw std::runtime_error("unsupported format for texel size!");
+    }
+}
+
 }
@@ -10,4 +10,9 @@ bool is_depth_stencil_format(VkFormat format);
 
 bool is_depth_format(VkFormat format);
 
+bool is_write_access(VkAccessFlags2KHR access_mask);
+
+// 非压缩格式每个texel的字节数
+uint32_t get_format_texel_size(VkFormat format);
+
 } // namespace comet
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "comet/vulkan/compute_pipeline.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "comet/rendering/pipeline_registry.h"
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+namespace
+{
+inline uint32_t div_round_up(uint32_t value, uint32_t divisor)
+{
+    return (value + divisor - 1) / divisor;
+}
+} // namespace
+
+ComputePipeline::ComputePipeline(const Device &device, VkPipelineCache pipeline_cache, const std::shared_ptr<PipelineLayout> &layout,
+                                 const std::vector<uint32_t> &spirv, const SpecializationConstants &specialization,
+                                 const std::string &entry_point)
+    : m_device{device}, m_layout{layout}
+{
+    if (!m_layout)
+    {
+        throw std::runtime_error("compute pipeline requires a pipeline layout!");
+    }
+
+    ShaderReflection reflection(spirv);
+    if (reflection.get_stages() != VK_SHADER_STAGE_COMPUTE_BIT)
+    {
+        throw std::runtime_error("shader is not a compute shader!");
+    }
+    specialization.check(reflection);
+
+    m_workgroup_size = resolve_workgroup_size(reflection, specialization);
+
+    const auto &limits = m_device.get_physical_device().get_properties().limits;
+    uint64_t invocations = 1;
+    for (size_t axis = 0; axis < 3; ++axis)
+    {
+        if (m_workgroup_size[axis] == 0 || m_workgroup_size[axis] > limits.maxComputeWorkGroupSize[axis])
+        {
+            throw std::runtime_error("compute workgroup size exceeds device limits!");
+        }
+        invocations *= m_workgroup_size[axis];
+    }
+    if (invocations > limits.maxComputeWorkGroupInvocations)
+    {
+        throw std::runtime_error("compute workgroup invocations exceed device limits!");
+    }
+
+    // 着色器模块和管线的创建与注册表共用同一路径
+    ComputePipelineDesc desc{};
+    desc.shader = {VK_SHADER_STAGE_COMPUTE_BIT, spirv, entry_point, specialization};
+    desc.layout = m_layout;
+    m_handle = PipelineRegistry::create_compute_pipeline(m_device, pipeline_cache, desc);
+}
+
+ComputePipeline::~ComputePipeline()
+{
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(m_device.get_handle(), m_handle, nullptr);
+    }
+}
+
+VkPipeline ComputePipeline::get_handle() const
+{
+    return m_handle;
+}
+
+const std::shared_ptr<PipelineLayout> &ComputePipeline::get_layout() const
+{
+    return m_layout;
+}
+
+const std::array<uint32_t, 3> &ComputePipeline::get_workgroup_size() const
+{
+    return m_workgroup_size;
+}
+
+void ComputePipeline::bind(VkCommandBuffer command_buffer) const
+{
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_handle);
+}
+
+void ComputePipeline::bind_descriptor_sets(VkCommandBuffer command_buffer, uint32_t first_set, const std::vector<VkDescriptorSet> &descriptor_sets) const
+{
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_layout->get_handle(), first_set,
+                            static_cast<uint32_t>(descriptor_sets.size()), descriptor_sets.data(), 0, nullptr);
+}
+
+void ComputePipeline::push_constants(VkCommandBuffer command_buffer, const void *data, uint32_t size, uint32_t offset) const
+{
+    vkCmdPushConstants(command_buffer, m_layout->get_handle(), VK_SHADER_STAGE_COMPUTE_BIT, offset, size, data);
+}
+
+void ComputePipeline::dispatch(VkCommandBuffer command_buffer, uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) const
+{
+    const auto &limits = m_device.get_physical_device().get_properties().limits;
+    if (group_count_x > limits.maxComputeWorkGroupCount[0] || group_count_y > limits.maxComputeWorkGroupCount[1] ||
+        group_count_z > limits.maxComputeWorkGroupCount[2])
+    {
+        throw std::runtime_error("compute dispatch exceeds device workgroup count limits!");
+    }
+
+    // 空的调度什么也不做，不必记录
+    if (group_count_x == 0 || group_count_y == 0 || group_count_z == 0)
+    {
+        return;
+    }
+    vkCmdDispatch(command_buffer, group_count_x, group_count_y, group_count_z);
+}
+
+void ComputePipeline::dispatch_threads(VkCommandBuffer command_buffer, uint32_t thread_count_x, uint32_t thread_count_y, uint32_t thread_count_z) const
+{
+    dispatch(command_buffer,
+             div_round_up(thread_count_x, m_workgroup_size[0]),
+             div_round_up(thread_count_y, m_workgroup_size[1]),
+             div_round_up(thread_count_z, m_workgroup_size[2]));
+}
+
+void ComputePipeline::dispatch_indirect(VkCommandBuffer command_buffer, const Buffer &buffer, VkDeviceSize offset) const
+{
+    if (offset % 4 != 0 || offset + sizeof(VkDispatchIndirectCommand) > buffer.get_size())
+    {
+        throw std::runtime_error("invalid indirect dispatch offset!");
+    }
+    vkCmdDispatchIndirect(command_buffer, buffer.get_handle(), offset);
+}
+
+std::array<uint32_t, 3> ComputePipeline::resolve_workgroup_size(const ShaderReflection &reflection, const SpecializationConstants &specialization)
+{
+    const auto &workgroup_size = reflection.get_workgroup_size();
+    auto size = workgroup_size.size;
+
+    const auto &entries = specialization.get_entries();
+    const auto &data = specialization.get_data();
+    for (size_t axis = 0; axis < 3; ++axis)
+    {
+        if (workgroup_size.spec_ids[axis] == UINT32_MAX)
+        {
+            continue;
+        }
+
+        auto found = std::find_if(entries.begin(), entries.end(), [&](const VkSpecializationMapEntry &entry)
+                                  { return entry.constantID == workgroup_size.spec_ids[axis]; });
+        // 工作组大小是32位整数，check已经保证大小一致
+        if (found != entries.end() && found->size == sizeof(uint32_t))
+        {
+            std::memcpy(&size[axis], data.data() + found->offset, sizeof(uint32_t));
+        }
+    }
+    return size;
+}
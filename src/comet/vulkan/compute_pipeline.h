@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/buffer.h"
+#include "comet/vulkan/pipeline_layout.h"
+#include "comet/vulkan/shader_reflection.h"
+#include "comet/vulkan/specialization_constants.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 计算管线，工作组大小由着色器反射得到(包括通过特化常量覆盖的维度)，
+    /// dispatch_threads按线程数向上取整计算工作组数量。
+    /// 只记录命令，在图形队列还是异步计算队列执行由调用者(或RenderGraph的通道队列)决定
+    class ComputePipeline
+    {
+    public:
+        /// 着色器不是计算着色器、特化常量未声明或工作组超出设备限制时抛出异常
+        ComputePipeline(const Device &device, VkPipelineCache pipeline_cache, const std::shared_ptr<PipelineLayout> &layout,
+                        const std::vector<uint32_t> &spirv, const SpecializationConstants &specialization = {},
+                        const std::string &entry_point = "main");
+
+        ComputePipeline(const ComputePipeline &) = delete;
+
+        ComputePipeline(ComputePipeline &&) = delete;
+
+        ~ComputePipeline();
+
+        ComputePipeline &operator=(const ComputePipeline &) = delete;
+
+        ComputePipeline &operator=(ComputePipeline &&) = delete;
+
+        VkPipeline get_handle() const;
+
+        const std::shared_ptr<PipelineLayout> &get_layout() const;
+
+        const std::array<uint32_t, 3> &get_workgroup_size() const;
+
+        void bind(VkCommandBuffer command_buffer) const;
+
+        void bind_descriptor_sets(VkCommandBuffer command_buffer, uint32_t first_set, const std::vector<VkDescriptorSet> &descriptor_sets) const;
+
+        void push_constants(VkCommandBuffer command_buffer, const void *data, uint32_t size, uint32_t offset = 0) const;
+
+        /// 工作组数量，超出maxComputeWorkGroupCount时抛出异常
+        void dispatch(VkCommandBuffer command_buffer, uint32_t group_count_x, uint32_t group_count_y = 1, uint32_t group_count_z = 1) const;
+
+        /// 线程数量，按工作组大小向上取整，着色器需要自己丢弃越界的线程
+        void dispatch_threads(VkCommandBuffer command_buffer, uint32_t thread_count_x, uint32_t thread_count_y = 1, uint32_t thread_count_z = 1) const;
+
+        /// 参数是buffer中offset处的VkDispatchIndirectCommand，缓冲需要VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT。
+        /// 由计算着色器写入时，之间需要到VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR的缓冲屏障
+        void dispatch_indirect(VkCommandBuffer command_buffer, const Buffer &buffer, VkDeviceSize offset = 0) const;
+
+        /// 着色器中的工作组大小，由特化常量决定的维度使用specialization中的值
+        static std::array<uint32_t, 3> resolve_workgroup_size(const ShaderReflection &reflection, const SpecializationConstants &specialization);
+
+    private:
+        const Device &m_device;
+
+        VkPipeline m_handle{VK_NULL_HANDLE};
+
+        std::shared_ptr<PipelineLayout> m_layout;
+
+        std::array<uint32_t, 3> m_workgroup_size{1, 1, 1};
+    };
+} // namespace comet
@@ -0,0 +1,118 @@
+#include "comet/vulkan/deletion_queue.h"
+
+#include "comet/vulkan/device.h"
+#include "comet/vulkan/queue.h"
+
+using namespace comet;
+
+DeletionQueue::DeletionQueue(Device &device)
+    : m_device{device}
+{
+}
+
+DeletionQueue::~DeletionQueue()
+{
+    flush();
+}
+
+void DeletionQueue::push(std::function<void()> deleter)
+{
+    Entry entry{};
+    entry.deleter = std::move(deleter);
+
+    // 资源可能在任意队列上使用过，记录所有队列的进度
+    for (const auto &family : m_device.get_queues())
+    {
+        for (const auto &queue : family)
+        {
+            uint64_t value = queue.get_last_submitted_value();
+            if (value > 0)
+            {
+                entry.wait_values.emplace_back(&queue, value);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_entries.push_back(std::move(entry));
+}
+
+size_t DeletionQueue::collect()
+{
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        // 保持相对顺序，先释放的资源先销毁
+        auto kept = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (is_complete(*it))
+            {
+                ready.push_back(std::move(it->deleter));
+            }
+            else
+            {
+                if (kept != it)
+                {
+                    *kept = std::move(*it);
+                }
+                ++kept;
+            }
+        }
+        m_entries.erase(kept, m_entries.end());
+    }
+
+    // 删除函数可能再次push，不能持有锁
+    for (auto &deleter : ready)
+    {
+        deleter();
+    }
+
+    return ready.size();
+}
+
+void DeletionQueue::flush()
+{
+    // 删除函数可能再次push，直到队列为空
+    while (true)
+    {
+        std::vector<Entry> entries;
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            entries.swap(m_entries);
+        }
+
+        if (entries.empty())
+        {
+            return;
+        }
+
+        for (auto &entry : entries)
+        {
+            for (const auto &wait_value : entry.wait_values)
+            {
+                wait_value.first->wait(wait_value.second);
+            }
+            entry.deleter();
+        }
+    }
+}
+
+size_t DeletionQueue::size() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_entries.size();
+}
+
+bool DeletionQueue::is_complete(const Entry &entry) const
+{
+    for (const auto &wait_value : entry.wait_values)
+    {
+        if (!wait_value.first->is_complete(wait_value.second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace comet
+{
+    class Device;
+
+    class Queue;
+
+    /// 延迟销毁：push时记录每个队列最后一次提交的时间线值，
+    /// 等GPU越过这些值后再执行删除，不需要让整个设备空闲。
+    /// 可以在任意线程push，collect一般每帧在渲染线程调用一次
+    class DeletionQueue
+    {
+    public:
+        explicit DeletionQueue(Device &device);
+
+        DeletionQueue(const DeletionQueue &) = delete;
+
+        DeletionQueue(DeletionQueue &&) = delete;
+
+        /// 等待并执行所有剩余的删除
+        ~DeletionQueue();
+
+        DeletionQueue &operator=(const DeletionQueue &) = delete;
+
+        DeletionQueue &operator=(DeletionQueue &&) = delete;
+
+        /// 当前已提交的工作全部完成后调用deleter
+        void push(std::function<void()> deleter);
+
+        /// 持有resource直到当前已提交的工作全部完成
+        template <typename T>
+        void retire(std::unique_ptr<T> resource)
+        {
+            if (resource)
+            {
+                retire(std::shared_ptr<T>{std::move(resource)});
+            }
+        }
+
+        template <typename T>
+        void retire(std::shared_ptr<T> resource)
+        {
+            if (resource)
+            {
+                push([resource = std::move(resource)]() mutable
+                     { resource.reset(); });
+            }
+        }
+
+        /// 执行GPU已经完成的删除，返回执行的数量
+        size_t collect();
+
+        /// 等待GPU完成所有相关的提交并执行全部删除
+        void flush();
+
+        size_t size() const;
+
+    private:
+        struct Entry
+        {
+            /// 每个有提交的队列及其需要完成的值
+            std::vector<std::pair<const Queue *, uint64_t>> wait_values;
+
+            std::function<void()> deleter;
+        };
+
+        bool is_complete(const Entry &entry) const;
+
+    private:
+        Device &m_device;
+
+        std::vector<Entry> m_entries;
+
+        mutable std::mutex m_mutex;
+    };
+} // namespace comet
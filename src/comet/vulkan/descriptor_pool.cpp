@@ -0,0 +1,168 @@
+#include "comet/vulkan/descriptor_pool.h"
+
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+namespace
+{
+bool is_buffer_descriptor(VkDescriptorType type)
+{
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+           type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
+
+bool is_texel_buffer_descriptor(VkDescriptorType type)
+{
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+}
+
+bool is_image_descriptor(VkDescriptorType type)
+{
+    return type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+           type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
+           type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+}
+} // namespace
+
+DescriptorPool::DescriptorPool(const Device &device, uint32_t max_sets, const std::vector<VkDescriptorPoolSize> &pool_sizes)
+    : m_device{device}, m_max_sets{max_sets}
+{
+    VkDescriptorPoolCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    info.maxSets = max_sets;
+    info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+    info.pPoolSizes = pool_sizes.data();
+
+    if (vkCreateDescriptorPool(m_device.get_handle(), &info, nullptr, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create descriptor pool!");
+    }
+}
+
+DescriptorPool::~DescriptorPool()
+{
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(m_device.get_handle(), m_handle, nullptr);
+    }
+}
+
+VkDescriptorPool DescriptorPool::get_handle() const
+{
+    return m_handle;
+}
+
+VkDescriptorSet DescriptorPool::allocate(const DescriptorSetLayout &layout)
+{
+    auto set_layout = layout.get_handle();
+
+    VkDescriptorSetAllocateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    info.descriptorPool = m_handle;
+    info.descriptorSetCount = 1;
+    info.pSetLayouts = &set_layout;
+
+    VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+    if (m_allocated_count >= m_max_sets ||
+        vkAllocateDescriptorSets(m_device.get_handle(), &info, &descriptor_set) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate descriptor set!");
+    }
+    m_allocated_count++;
+    return descriptor_set;
+}
+
+void DescriptorPool::reset()
+{
+    vkResetDescriptorPool(m_device.get_handle(), m_handle, 0);
+    m_allocated_count = 0;
+}
+
+uint32_t DescriptorPool::get_allocated_count() const
+{
+    return m_allocated_count;
+}
+
+DescriptorWriter &DescriptorWriter::write_buffer(uint32_t binding, VkDescriptorType type, const Buffer &buffer,
+                                                 VkDeviceSize offset, VkDeviceSize range, uint32_t array_element)
+{
+    if (!is_buffer_descriptor(type))
+    {
+        throw std::runtime_error("descriptor type is not a buffer type!");
+    }
+
+    m_writes.push_back({binding, array_element, type, m_buffer_infos.size()});
+    m_buffer_infos.push_back({buffer.get_handle(), offset, range});
+    return *this;
+}
+
+DescriptorWriter &DescriptorWriter::write_image(uint32_t binding, VkDescriptorType type, const ImageView &image_view,
+                                                VkImageLayout layout, VkSampler sampler, uint32_t array_element)
+{
+    if (!is_image_descriptor(type))
+    {
+        throw std::runtime_error("descriptor type is not an image type!");
+    }
+    if (type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE && layout != VK_IMAGE_LAYOUT_GENERAL)
+    {
+        throw std::runtime_error("storage images must be in general layout!");
+    }
+
+    m_writes.push_back({binding, array_element, type, m_image_infos.size()});
+    m_image_infos.push_back({sampler, image_view.get_handle(), layout});
+    return *this;
+}
+
+DescriptorWriter &DescriptorWriter::write_texel_buffer(uint32_t binding, VkDescriptorType type, VkBufferView buffer_view, uint32_t array_element)
+{
+    if (!is_texel_buffer_descriptor(type))
+    {
+        throw std::runtime_error("descriptor type is not a texel buffer type!");
+    }
+
+    m_writes.push_back({binding, array_element, type, m_texel_buffer_views.size()});
+    m_texel_buffer_views.push_back(buffer_view);
+    return *this;
+}
+
+void DescriptorWriter::update(const Device &device, VkDescriptorSet descriptor_set)
+{
+    std::vector<VkWriteDescriptorSet> writes;
+    writes.reserve(m_writes.size());
+    for (const auto &write : m_writes)
+    {
+        VkWriteDescriptorSet info{};
+        info.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        info.dstSet = descriptor_set;
+        info.dstBinding = write.binding;
+        info.dstArrayElement = write.array_element;
+        info.descriptorCount = 1;
+        info.descriptorType = write.type;
+        if (is_buffer_descriptor(write.type))
+        {
+            info.pBufferInfo = &m_buffer_infos[write.info_index];
+        }
+        else if (is_texel_buffer_descriptor(write.type))
+        {
+            info.pTexelBufferView = &m_texel_buffer_views[write.info_index];
+        }
+        else
+        {
+            info.pImageInfo = &m_image_infos[write.info_index];
+        }
+        writes.push_back(info);
+    }
+
+    vkUpdateDescriptorSets(device.get_handle(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+void DescriptorWriter::clear()
+{
+    m_writes.clear();
+    m_buffer_infos.clear();
+    m_image_infos.clear();
+    m_texel_buffer_views.clear();
+}
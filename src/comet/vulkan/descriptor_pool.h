@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/buffer.h"
+#include "comet/vulkan/descriptor_set_layout.h"
+#include "comet/vulkan/image_view.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 描述符集从池中分配，不单独释放，整个池reset后重新分配。
+    /// 每帧一个池时，等待该帧的栅栏后reset即可
+    class DescriptorPool
+    {
+    public:
+        DescriptorPool(const Device &device, uint32_t max_sets, const std::vector<VkDescriptorPoolSize> &pool_sizes);
+
+        DescriptorPool(const DescriptorPool &) = delete;
+
+        DescriptorPool(DescriptorPool &&) = delete;
+
+        ~DescriptorPool();
+
+        DescriptorPool &operator=(const DescriptorPool &) = delete;
+
+        DescriptorPool &operator=(DescriptorPool &&) = delete;
+
+        VkDescriptorPool get_handle() const;
+
+        /// 池已满时抛出异常
+        VkDescriptorSet allocate(const DescriptorSetLayout &layout);
+
+        /// 之前分配的描述符集全部失效
+        void reset();
+
+        uint32_t get_allocated_count() const;
+
+    private:
+        const Device &m_device;
+
+        VkDescriptorPool m_handle{VK_NULL_HANDLE};
+
+        uint32_t m_max_sets;
+
+        uint32_t m_allocated_count{0};
+    };
+
+    /// 收集一个描述符集的写入，update时一次vkUpdateDescriptorSets
+    class DescriptorWriter
+    {
+    public:
+        /// 存储缓冲、uniform缓冲等
+        DescriptorWriter &write_buffer(uint32_t binding, VkDescriptorType type, const Buffer &buffer,
+                                       VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE, uint32_t array_element = 0);
+
+        /// 存储图像使用VK_IMAGE_LAYOUT_GENERAL，采样图像使用VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        DescriptorWriter &write_image(uint32_t binding, VkDescriptorType type, const ImageView &image_view,
+                                      VkImageLayout layout, VkSampler sampler = VK_NULL_HANDLE, uint32_t array_element = 0);
+
+        /// uniform/存储纹素缓冲，视图由调用者持有
+        DescriptorWriter &write_texel_buffer(uint32_t binding, VkDescriptorType type, VkBufferView buffer_view, uint32_t array_element = 0);
+
+        void update(const Device &device, VkDescriptorSet descriptor_set);
+
+        void clear();
+
+    private:
+        struct Write
+        {
+            uint32_t binding;
+
+            uint32_t array_element;
+
+            VkDescriptorType type;
+
+            /// 在m_buffer_infos、m_image_infos或m_texel_buffer_views中的下标，update时才取指针，添加写入不会使其失效
+            size_t info_index;
+        };
+
+        std::vector<Write> m_writes;
+
+        std::vector<VkDescriptorBufferInfo> m_buffer_infos;
+
+        std::vector<VkDescriptorImageInfo> m_image_infos;
+
+        std::vector<VkBufferView> m_texel_buffer_views;
+    };
+} // namespace comet
@@ -0,0 +1,39 @@
+#include "comet/vulkan/descriptor_set_layout.h"
+
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+DescriptorSetLayout::DescriptorSetLayout(const Device &device, const std::vector<VkDescriptorSetLayoutBinding> &bindings)
+    : m_device(device), m_bindings(bindings)
+{
+    VkDescriptorSetLayoutCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    info.bindingCount = static_cast<uint32_t>(m_bindings.size());
+    info.pBindings = m_bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_device.get_handle(), &info, nullptr, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create descriptor set layout!");
+    }
+}
+
+DescriptorSetLayout::~DescriptorSetLayout()
+{
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(m_device.get_handle(), m_handle, nullptr);
+    }
+}
+
+VkDescriptorSetLayout DescriptorSetLayout::get_handle() const
+{
+    return m_handle;
+}
+
+const std::vector<VkDescriptorSetLayoutBinding> &DescriptorSetLayout::get_bindings() const
+{
+    return m_bindings;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include "volk.h"
+
+namespace comet
+{
+    class Device;
+
+    class DescriptorSetLayout
+    {
+    public:
+        DescriptorSetLayout(const Device &device, const std::vector<VkDescriptorSetLayoutBinding> &bindings);
+
+        DescriptorSetLayout(const DescriptorSetLayout &) = delete;
+
+        DescriptorSetLayout(DescriptorSetLayout &&) = delete;
+
+        ~DescriptorSetLayout();
+
+        DescriptorSetLayout &operator=(const DescriptorSetLayout &) = delete;
+
+        DescriptorSetLayout &operator=(DescriptorSetLayout &&) = delete;
+
+        VkDescriptorSetLayout get_handle() const;
+
+        const std::vector<VkDescriptorSetLayoutBinding> &get_bindings() const;
+
+    private:
+        const Device &m_device;
+
+        VkDescriptorSetLayout m_handle{VK_NULL_HANDLE};
+
+        std::vector<VkDescriptorSetLayoutBinding> m_bindings;
+    };
+} // namespace comet
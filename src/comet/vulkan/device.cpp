@@ -1,5 +1,7 @@
 #include "comet/vulkan/device.h"
 
+#include "comet/vulkan/instance.h"
+
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
@@ -58,8 +60,60 @@ Device::Device(const PhysicalDevice &physical_device, VkSurfaceKHR surface, cons
     create_info.queueCreateInfoCount = queue_create_infos.size();
     create_info.pQueueCreateInfos = queue_create_infos.data();
     // 添加设备特性
-    VkPhysicalDeviceFeatures device_features{};
-    create_info.pEnabledFeatures = &device_features;
+    VkPhysicalDeviceVulkan11Features supported_vulkan11_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES};
+    VkPhysicalDeviceVulkan12Features supported_vulkan12_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    supported_vulkan11_features.pNext = &supported_vulkan12_features;
+    VkPhysicalDeviceFeatures2 supported_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    supported_features.pNext = &supported_vulkan11_features;
+    // 动态渲染是可选的扩展，支持时开启，渲染时可以不创建渲染通道和帧缓冲
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR supported_dynamic_rendering_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR};
+    if (is_extension_supported(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+    {
+        supported_vulkan12_features.pNext = &supported_dynamic_rendering_features;
+    }
+    vkGetPhysicalDeviceFeatures2(m_physical_device.get_handle(), &supported_features);
+    // 时间线信号量：Queue用它跟踪每次提交的完成情况，1.2核心特性但需要显式开启
+    if (!supported_vulkan12_features.timelineSemaphore)
+    {
+        throw std::runtime_error("physical device does not support timeline semaphores!");
+    }
+
+    // 间接绘制相关的特性是可选的，IndirectBatcher按开启情况选择绘制方式
+    m_enabled_features.multiDrawIndirect = supported_features.features.multiDrawIndirect;
+    m_enabled_features.drawIndirectFirstInstance = supported_features.features.drawIndirectFirstInstance;
+    create_info.pEnabledFeatures = &m_enabled_features;
+
+    // gl_DrawID
+    VkPhysicalDeviceVulkan11Features vulkan11_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES};
+    vulkan11_features.shaderDrawParameters = supported_vulkan11_features.shaderDrawParameters;
+    VkPhysicalDeviceVulkan12Features vulkan12_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    vulkan12_features.timelineSemaphore = VK_TRUE;
+    vulkan12_features.drawIndirectCount = supported_vulkan12_features.drawIndirectCount;
+    vulkan11_features.pNext = &vulkan12_features;
+    create_info.pNext = &vulkan11_features;
+    m_shader_draw_parameters_enabled = vulkan11_features.shaderDrawParameters == VK_TRUE;
+    m_draw_indirect_count_enabled = vulkan12_features.drawIndirectCount == VK_TRUE;
+    // synchronization2：BarrierBuilder使用vkCmdPipelineBarrier2KHR
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR};
+    if (is_extension_enabled(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+    {
+        synchronization2_features.synchronization2 = VK_TRUE;
+        synchronization2_features.pNext = const_cast<void *>(create_info.pNext);
+        create_info.pNext = &synchronization2_features;
+    }
+    // 依赖的create_renderpass2和depth_stencil_resolve在1.2中是核心功能
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR};
+    if (supported_dynamic_rendering_features.dynamicRendering && !is_extension_enabled(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+    {
+        m_enabled_extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    }
+    if (is_extension_enabled(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+    {
+        dynamic_rendering_features.dynamicRendering = VK_TRUE;
+        dynamic_rendering_features.pNext = const_cast<void *>(create_info.pNext);
+        create_info.pNext = &dynamic_rendering_features;
+        m_dynamic_rendering_enabled = true;
+    }
     // 校验层
     create_info.enabledLayerCount = 0;
     // 扩展
@@ -73,23 +127,53 @@ Device::Device(const PhysicalDevice &physical_device, VkSurfaceKHR surface, cons
 
     volkLoadDevice(m_handle);
 
-    m_graphics_queue = std::make_unique<Queue>(*this, find_queue_family().graphicsFamily.value(), m_physical_device.get_queue_family_properties()[find_queue_family().graphicsFamily.value()], m_physical_device.is_present_supported(nullptr, find_queue_family().graphicsFamily.value()), 0);
+    // 创建内存分配器，函数指针通过volk加载的入口获取
+    VmaVulkanFunctions vma_vulkan_functions{};
+    vma_vulkan_functions.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
+    vma_vulkan_functions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
+
+    VmaAllocatorCreateInfo allocator_info{};
+    allocator_info.physicalDevice = m_physical_device.get_handle();
+    allocator_info.device = m_handle;
+    allocator_info.instance = m_physical_device.get_instance().get_handle();
+    allocator_info.vulkanApiVersion = VK_API_VERSION_1_2;
+    allocator_info.pVulkanFunctions = &vma_vulkan_functions;
+
+    if (vmaCreateAllocator(&allocator_info, &m_memory_allocator) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create memory allocator!");
+    }
 
+    // 每个队列持有自己的时间线信号量，不能再为同一个VkQueue创建额外的Queue对象
     m_queues.resize(queue_family_properties_count);
     for (uint32_t queue_family_index = 0; queue_family_index < queue_family_properties_count; ++queue_family_index)
     {
         const auto &queue_family_property = m_physical_device.get_queue_family_properties()[queue_family_index];
 
         auto support_present = m_physical_device.is_present_supported(nullptr, queue_family_index);
+        m_queues[queue_family_index].reserve(queue_family_property.queueCount);
         for (uint32_t queue_index = 0; queue_index < queue_family_property.queueCount; ++queue_index)
         {
             m_queues[queue_family_index].emplace_back(Queue{*this, queue_family_index, queue_family_property, support_present, queue_index});
         }
     }
+
+    m_deletion_queue = std::make_unique<DeletionQueue>(*this);
 }
 
 Device::~Device()
 {
+    // 延迟删除的资源依赖队列的时间线，先于队列销毁
+    m_deletion_queue.reset();
+
+    // 队列的时间线信号量要在设备之前销毁
+    m_queues.clear();
+
+    if (m_memory_allocator != VK_NULL_HANDLE)
+    {
+        vmaDestroyAllocator(m_memory_allocator);
+    }
+
     vkDestroyDevice(m_handle, nullptr);
 }
 
@@ -108,12 +192,22 @@ VmaAllocator Device::get_memory_allocator() const
     return m_memory_allocator;
 }
 
-const Queue &Device::get_queue(uint32_t queue_family_index, uint32_t queue_index)
+const std::vector<std::vector<Queue>> &Device::get_queues() const
+{
+    return m_queues;
+}
+
+DeletionQueue &Device::get_deletion_queue()
+{
+    return *m_deletion_queue;
+}
+
+Queue &Device::get_queue(uint32_t queue_family_index, uint32_t queue_index)
 {
 	return m_queues[queue_family_index][queue_index];
 }
 
-const Queue &Device::get_queue_by_flags(VkQueueFlags required_queue_flags, uint32_t queue_index) const
+Queue &Device::get_queue_by_flags(VkQueueFlags required_queue_flags, uint32_t queue_index)
 {
 	for (uint32_t queue_family_index = 0U; queue_family_index < m_queues.size(); ++queue_family_index)
 	{
@@ -131,7 +225,7 @@ const Queue &Device::get_queue_by_flags(VkQueueFlags required_queue_flags, uint3
 	throw std::runtime_error("Queue not found");
 }
 
-const Queue &Device::get_queue_by_present(uint32_t queue_index) const
+Queue &Device::get_queue_by_present(uint32_t queue_index)
 {
 	for (uint32_t queue_family_index = 0U; queue_family_index < m_queues.size(); ++queue_family_index)
 	{
@@ -181,4 +275,24 @@ bool Device::is_extension_enabled(const char *extension_name) const
 {
     return std::find_if(m_enabled_extensions.begin(), m_enabled_extensions.end(), [extension_name](const char *enabled_extension)
                         { return std::strcmp(extension_name, enabled_extension) == 0; }) != m_enabled_extensions.end();
-}
\ No newline at end of file
+}
+
+const VkPhysicalDeviceFeatures &Device::get_enabled_features() const
+{
+    return m_enabled_features;
+}
+
+bool Device::is_draw_indirect_count_enabled() const
+{
+    return m_draw_indirect_count_enabled;
+}
+
+bool Device::is_shader_draw_parameters_enabled() const
+{
+    return m_shader_draw_parameters_enabled;
+}
+
+bool Device::is_dynamic_rendering_enabled() const
+{
+    return m_dynamic_rendering_enabled;
+}
@@ -9,6 +9,7 @@
 
 #include "comet/vulkan/physical_device.h"
 #include "comet/vulkan/queue.h"
+#include "comet/vulkan/deletion_queue.h"
 
 namespace comet
 {
@@ -34,11 +35,18 @@ namespace comet
 
 	    VmaAllocator get_memory_allocator() const;
 
-        const Queue &get_queue(uint32_t queue_family_index, uint32_t queue_index);
+        /// 提交会推进队列的时间线，所以返回可修改的引用
+        Queue &get_queue(uint32_t queue_family_index, uint32_t queue_index);
 
-        const Queue &get_queue_by_flags(VkQueueFlags queue_flags, uint32_t queue_index) const;
+        Queue &get_queue_by_flags(VkQueueFlags queue_flags, uint32_t queue_index);
 
-        const Queue &get_queue_by_present(uint32_t queue_index) const;
+        Queue &get_queue_by_present(uint32_t queue_index);
+
+        /// 按队列族排列的所有队列
+        const std::vector<std::vector<Queue>> &get_queues() const;
+
+        /// 释放可能仍被GPU使用的资源，GPU完成当前的提交后再销毁
+        DeletionQueue &get_deletion_queue();
 
 
         QueueFamilyIndices find_queue_family();
@@ -47,6 +55,18 @@ namespace comet
 
         bool is_extension_enabled(const char *extension_name) const;
 
+        /// 创建设备时开启的核心特性
+        const VkPhysicalDeviceFeatures &get_enabled_features() const;
+
+        /// vkCmdDrawIndexedIndirectCount可用
+        bool is_draw_indirect_count_enabled() const;
+
+        /// 着色器可以使用gl_DrawID
+        bool is_shader_draw_parameters_enabled() const;
+
+        /// 可以用vkCmdBeginRenderingKHR代替渲染通道和帧缓冲
+        bool is_dynamic_rendering_enabled() const;
+
     private:
         const PhysicalDevice &m_physical_device;
 
@@ -57,11 +77,18 @@ namespace comet
         std::vector<VkExtensionProperties> m_available_extensions;
         std::vector<const char*> m_enabled_extensions;
 
-        std::unique_ptr<Queue> m_graphics_queue;
-        std::unique_ptr<Queue> m_present_queue;
+        VkPhysicalDeviceFeatures m_enabled_features{};
+
+        bool m_draw_indirect_count_enabled{false};
+
+        bool m_shader_draw_parameters_enabled{false};
+
+        bool m_dynamic_rendering_enabled{false};
 
         VmaAllocator m_memory_allocator{VK_NULL_HANDLE};
 
         std::vector<std::vector<Queue>> m_queues;
+
+        std::unique_ptr<DeletionQueue> m_deletion_queue;
     };
 }
\ No newline at end of file
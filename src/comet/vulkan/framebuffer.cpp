@@ -0,0 +1,56 @@
+#include "comet/vulkan/framebuffer.h"
+
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+Framebuffer::Framebuffer(const Device &device, const std::shared_ptr<RenderPass> &render_pass,
+                         const std::vector<std::shared_ptr<ImageView>> &attachments, VkExtent2D extent, uint32_t layers)
+    : m_device(device), m_render_pass(render_pass), m_attachments(attachments), m_extent(extent)
+{
+    std::vector<VkImageView> views;
+    views.reserve(m_attachments.size());
+    for (const auto &attachment : m_attachments)
+    {
+        views.push_back(attachment->get_handle());
+    }
+
+    VkFramebufferCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    create_info.renderPass = m_render_pass->get_handle();
+    create_info.attachmentCount = static_cast<uint32_t>(views.size());
+    create_info.pAttachments = views.data();
+    create_info.width = extent.width;
+    create_info.height = extent.height;
+    create_info.layers = layers;
+
+    if (vkCreateFramebuffer(m_device.get_handle(), &create_info, nullptr, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create framebuffer!");
+    }
+}
+
+Framebuffer::~Framebuffer()
+{
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        vkDestroyFramebuffer(m_device.get_handle(), m_handle, nullptr);
+    }
+}
+
+VkFramebuffer Framebuffer::get_handle() const
+{
+    return m_handle;
+}
+
+const RenderPass &Framebuffer::get_render_pass() const
+{
+    return *m_render_pass;
+}
+
+VkExtent2D Framebuffer::get_extent() const
+{
+    return m_extent;
+}
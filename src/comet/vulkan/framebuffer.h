@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/image_view.h"
+#include "comet/vulkan/render_pass.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 持有渲染通道和图像视图，保证它们比帧缓冲活得久
+    class Framebuffer
+    {
+    public:
+        Framebuffer(const Device &device, const std::shared_ptr<RenderPass> &render_pass,
+                    const std::vector<std::shared_ptr<ImageView>> &attachments, VkExtent2D extent, uint32_t layers = 1);
+
+        Framebuffer(const Framebuffer &) = delete;
+
+        Framebuffer(Framebuffer &&) = delete;
+
+        ~Framebuffer();
+
+        Framebuffer &operator=(const Framebuffer &) = delete;
+
+        Framebuffer &operator=(Framebuffer &&) = delete;
+
+        VkFramebuffer get_handle() const;
+
+        const RenderPass &get_render_pass() const;
+
+        VkExtent2D get_extent() const;
+
+    private:
+        const Device &m_device;
+
+        VkFramebuffer m_handle{VK_NULL_HANDLE};
+
+        std::shared_ptr<RenderPass> m_render_pass;
+
+        std::vector<std::shared_ptr<ImageView>> m_attachments;
+
+        VkExtent2D m_extent;
+    };
+} // namespace comet
@@ -0,0 +1,174 @@
+#include "comet/vulkan/headless_swapchain.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+using namespace comet;
+
+HeadlessSwapchain::HeadlessSwapchain(Device &device,
+                                     const VkExtent2D &extent,
+                                     VkFormat format,
+                                     uint32_t image_count,
+                                     PacingMode pacing_mode,
+                                     double refresh_rate,
+                                     VkImageUsageFlags image_usage)
+    : m_device{device}, m_queue{device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0)}, m_extent{extent}, m_format{format}, m_usage{image_usage}, m_pacing_mode{pacing_mode}
+{
+    if (image_count == 0)
+    {
+        throw std::runtime_error("headless swapchain needs at least one image!");
+    }
+
+    for (uint32_t i = 0; i < image_count; ++i)
+    {
+        m_owned_images.push_back(std::make_unique<Image>(m_device, VkExtent3D{extent.width, extent.height, 1}, format, image_usage, VMA_MEMORY_USAGE_GPU_ONLY));
+        m_images.push_back(m_owned_images.back()->get_handle());
+    }
+    m_present_values.resize(image_count, 0);
+    m_available_at.resize(image_count);
+
+    set_pacing_mode(pacing_mode, refresh_rate);
+}
+
+HeadlessSwapchain::~HeadlessSwapchain()
+{
+    // 等待最后的呈现提交完成，之后才能释放图像
+    m_queue.wait(*std::max_element(m_present_values.begin(), m_present_values.end()));
+}
+
+VkResult HeadlessSwapchain::acquire_next_image(uint32_t &image_index, VkSemaphore image_acquired_semaphore, VkFence fence)
+{
+    // 按顺序轮转，和FIFO交换链的行为一致
+    image_index = m_next_image;
+    m_next_image = (m_next_image + 1) % static_cast<uint32_t>(m_images.size());
+
+    // 上次呈现这张图像的提交完成后才能再次使用
+    m_queue.wait(m_present_values[image_index]);
+
+    if (m_pacing_mode == PacingMode::Vsync)
+    {
+        std::this_thread::sleep_until(m_available_at[image_index]);
+    }
+
+    // 没有呈现引擎，用一次空提交触发信号量和栅栏
+    if (image_acquired_semaphore != VK_NULL_HANDLE || fence != VK_NULL_HANDLE)
+    {
+        std::vector<VkSemaphore> signal_semaphores;
+        if (image_acquired_semaphore != VK_NULL_HANDLE)
+        {
+            signal_semaphores.push_back(image_acquired_semaphore);
+        }
+
+        try
+        {
+            m_queue.submit({}, {}, {}, signal_semaphores, {}, fence);
+        }
+        catch (const std::runtime_error &)
+        {
+            return VK_ERROR_DEVICE_LOST;
+        }
+    }
+
+    return VK_SUCCESS;
+}
+
+VkResult HeadlessSwapchain::present(VkQueue queue, uint32_t image_index, VkSemaphore wait_semaphore)
+{
+    // 时间线只能跟踪自己队列上的提交
+    if (queue != m_queue.get_handle())
+    {
+        throw std::runtime_error("headless swapchain must present on its graphics queue!");
+    }
+
+    // 消耗渲染完成的信号量，这次提交完成表示图像被"释放"
+    std::vector<VkSemaphore> wait_semaphores;
+    std::vector<VkPipelineStageFlags> wait_stages;
+    if (wait_semaphore != VK_NULL_HANDLE)
+    {
+        wait_semaphores.push_back(wait_semaphore);
+        wait_stages.push_back(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    }
+
+    try
+    {
+        m_present_values[image_index] = m_queue.submit({}, wait_semaphores, wait_stages);
+    }
+    catch (const std::runtime_error &)
+    {
+        return VK_ERROR_DEVICE_LOST;
+    }
+
+    auto now = Clock::now();
+    switch (m_pacing_mode)
+    {
+    case PacingMode::FixedRate:
+        // 落后超过一个周期时不追赶，从当前时刻重新计时
+        if (m_next_tick + m_period < now)
+        {
+            m_next_tick = now;
+        }
+        std::this_thread::sleep_until(m_next_tick);
+        m_next_tick += m_period;
+        break;
+    case PacingMode::Vsync:
+    {
+        // 在下一个刷新时刻显示，显示一个周期后被下一张图像替换
+        auto scanout = std::max(now, m_next_tick + m_period);
+        m_next_tick = scanout;
+        m_available_at[image_index] = scanout + m_period;
+        break;
+    }
+    default:
+        break;
+    }
+
+    return VK_SUCCESS;
+}
+
+const std::vector<VkImage> &HeadlessSwapchain::get_images() const
+{
+    return m_images;
+}
+
+VkFormat HeadlessSwapchain::get_format() const
+{
+    return m_format;
+}
+
+const VkExtent2D &HeadlessSwapchain::get_extent() const
+{
+    return m_extent;
+}
+
+VkImageUsageFlags HeadlessSwapchain::get_usage() const
+{
+    return m_usage;
+}
+
+VkImageLayout HeadlessSwapchain::get_present_layout() const
+{
+    // 没有VK_KHR_swapchain时不能使用PRESENT_SRC，保持可回读的布局
+    return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+}
+
+void HeadlessSwapchain::set_pacing_mode(PacingMode pacing_mode, double refresh_rate)
+{
+    if (pacing_mode != PacingMode::Unthrottled && refresh_rate <= 0.0)
+    {
+        throw std::runtime_error("headless swapchain refresh rate must be positive!");
+    }
+
+    m_pacing_mode = pacing_mode;
+    if (refresh_rate > 0.0)
+    {
+        m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / refresh_rate));
+    }
+    m_next_tick = Clock::now();
+    std::fill(m_available_at.begin(), m_available_at.end(), Clock::time_point{});
+}
+
+PacingMode HeadlessSwapchain::get_pacing_mode() const
+{
+    return m_pacing_mode;
+}
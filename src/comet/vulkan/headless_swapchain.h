@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/device.h"
+#include "comet/vulkan/queue.h"
+#include "comet/vulkan/image.h"
+#include "comet/vulkan/presenter.h"
+
+namespace comet
+{
+    /// 离屏呈现的节奏
+    enum class PacingMode
+    {
+        /// 不限速，只受GPU速度和图像数量限制
+        Unthrottled,
+        /// 每次present阻塞到下一个固定间隔
+        FixedRate,
+        /// 模拟FIFO：每个刷新周期显示一张图像，图像显示完才能再次获取
+        Vsync
+    };
+
+    /// 用一组离屏Image模拟交换链，用于没有显示器的渲染节点和CI(lavapipe)
+    class HeadlessSwapchain : public Presenter
+    {
+    public:
+        HeadlessSwapchain(Device &device,
+                          const VkExtent2D &extent,
+                          VkFormat format = VK_FORMAT_R8G8B8A8_SRGB,
+                          uint32_t image_count = 3,
+                          PacingMode pacing_mode = PacingMode::Unthrottled,
+                          double refresh_rate = 60.0,
+                          VkImageUsageFlags image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+
+        HeadlessSwapchain(const HeadlessSwapchain &) = delete;
+
+        HeadlessSwapchain(HeadlessSwapchain &&) = delete;
+
+        ~HeadlessSwapchain() override;
+
+        HeadlessSwapchain &operator=(const HeadlessSwapchain &) = delete;
+
+        HeadlessSwapchain &operator=(HeadlessSwapchain &&) = delete;
+
+        VkResult acquire_next_image(uint32_t &image_index, VkSemaphore image_acquired_semaphore, VkFence fence = VK_NULL_HANDLE) override;
+
+        VkResult present(VkQueue queue, uint32_t image_index, VkSemaphore wait_semaphore) override;
+
+        const std::vector<VkImage> &get_images() const override;
+
+        VkFormat get_format() const override;
+
+        const VkExtent2D &get_extent() const override;
+
+        VkImageUsageFlags get_usage() const override;
+
+        VkImageLayout get_present_layout() const override;
+
+        void set_pacing_mode(PacingMode pacing_mode, double refresh_rate);
+
+        PacingMode get_pacing_mode() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        Device &m_device;
+
+        /// 获取和呈现都在这个队列上提交，用它的时间线跟踪图像何时被释放
+        Queue &m_queue;
+
+        VkExtent2D m_extent;
+
+        VkFormat m_format;
+
+        VkImageUsageFlags m_usage;
+
+        std::vector<std::unique_ptr<Image>> m_owned_images;
+
+        std::vector<VkImage> m_images;
+
+        /// 每张图像上次呈现提交在队列时间线上的值，完成后图像可以再次获取
+        std::vector<uint64_t> m_present_values;
+
+        /// Vsync模式下每张图像结束显示的时间
+        std::vector<Clock::time_point> m_available_at;
+
+        uint32_t m_next_image{0};
+
+        PacingMode m_pacing_mode;
+
+        Clock::duration m_period{};
+
+        /// FixedRate的下一个时刻，Vsync最近一次显示的时刻
+        Clock::time_point m_next_tick{};
+    };
+} // namespace comet
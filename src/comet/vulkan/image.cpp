@@ -3,8 +3,21 @@
 #include <cassert>
 #include <stdexcept>
 
+#include "comet/vulkan/common.h"
+
 using namespace comet;
 
+bool ImageState::operator==(const ImageState &other) const
+{
+    return layout == other.layout && stage_mask == other.stage_mask && access_mask == other.access_mask &&
+           write_stage_mask == other.write_stage_mask && write_access_mask == other.write_access_mask;
+}
+
+bool ImageState::operator!=(const ImageState &other) const
+{
+    return !(*this == other);
+}
+
 namespace
 {
 inline VkImageType find_image_type(VkExtent3D extent)
@@ -65,6 +78,8 @@ Image::Image(Device const &device,
 {
     m_subresource.mipLevel = 1;
     m_subresource.arrayLayer = 1;
+
+    m_states.resize(m_subresource.mipLevel * m_subresource.arrayLayer);
 }
 
 Image::Image(Device const         &device,
@@ -94,6 +109,8 @@ Image::Image(Device const         &device,
 	m_subresource.mipLevel   = mip_levels;
 	m_subresource.arrayLayer = array_layers;
 
+	m_states.resize(mip_levels * array_layers);
+
 	VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
 	image_info.flags       = flags;
 	image_info.imageType   = m_type;
@@ -129,6 +146,15 @@ Image::Image(Device const         &device,
 	}
 }
 
+Image::~Image()
+{
+    // 只销毁自己分配的图像，包装的外部图像（如交换链图像）由其所有者销毁
+    if (m_memory != VK_NULL_HANDLE)
+    {
+        vmaDestroyImage(m_device->get_memory_allocator(), m_handle, m_memory);
+    }
+}
+
 Device &Image::get_device() const
 {
     return *m_device;
@@ -154,6 +180,79 @@ VkImageSubresource Image::get_subresource() const
     return m_subresource;
 }
 
+uint32_t Image::get_mip_levels() const
+{
+    return m_subresource.mipLevel;
+}
+
+uint32_t Image::get_array_layers() const
+{
+    return m_subresource.arrayLayer;
+}
+
+VkImageAspectFlags Image::get_aspect_mask() const
+{
+    if (is_depth_only_format(m_format))
+    {
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    }
+
+    if (is_depth_stencil_format(m_format))
+    {
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+
+    return VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+VkImageSubresourceRange Image::resolve_range(const VkImageSubresourceRange &range) const
+{
+    VkImageSubresourceRange resolved = range;
+
+    if (resolved.aspectMask == 0)
+    {
+        resolved.aspectMask = get_aspect_mask();
+    }
+
+    if (resolved.levelCount == VK_REMAINING_MIP_LEVELS)
+    {
+        resolved.levelCount = get_mip_levels() - resolved.baseMipLevel;
+    }
+
+    if (resolved.layerCount == VK_REMAINING_ARRAY_LAYERS)
+    {
+        resolved.layerCount = get_array_layers() - resolved.baseArrayLayer;
+    }
+
+    assert(resolved.baseMipLevel + resolved.levelCount <= get_mip_levels() && "Mip range out of bounds");
+    assert(resolved.baseArrayLayer + resolved.layerCount <= get_array_layers() && "Layer range out of bounds");
+
+    return resolved;
+}
+
+const ImageState &Image::get_state(uint32_t mip_level, uint32_t array_layer) const
+{
+    return m_states[array_layer * get_mip_levels() + mip_level];
+}
+
+void Image::set_state(uint32_t mip_level, uint32_t array_layer, const ImageState &state)
+{
+    m_states[array_layer * get_mip_levels() + mip_level] = state;
+}
+
+void Image::set_state(const VkImageSubresourceRange &range, const ImageState &state)
+{
+    auto resolved = resolve_range(range);
+
+    for (uint32_t layer = resolved.baseArrayLayer; layer < resolved.baseArrayLayer + resolved.layerCount; ++layer)
+    {
+        for (uint32_t mip = resolved.baseMipLevel; mip < resolved.baseMipLevel + resolved.levelCount; ++mip)
+        {
+            set_state(mip, layer, state);
+        }
+    }
+}
+
 std::unordered_set<ImageView *> &Image::get_views()
 {
     return m_views;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_set>
+#include <vector>
 
 #include "volk.h"
 #include "vulkan/vulkan_core.h"
@@ -13,6 +14,26 @@ namespace comet
 
     class ImageView;
 
+    /// 子资源当前所处的布局，以及最近一次访问它的管线阶段和访问类型
+    struct ImageState
+    {
+        VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+        VkPipelineStageFlags2KHR stage_mask{VK_PIPELINE_STAGE_2_NONE_KHR};
+
+        VkAccessFlags2KHR access_mask{VK_ACCESS_2_NONE_KHR};
+
+        /// 最近一次写入(包括布局转换)的阶段和访问，只在Image跟踪的状态中使用。
+        /// 读后读时stage_mask/access_mask是已经与这次写入同步过的读取，新的读取阶段需要从这里建立依赖
+        VkPipelineStageFlags2KHR write_stage_mask{VK_PIPELINE_STAGE_2_NONE_KHR};
+
+        VkAccessFlags2KHR write_access_mask{VK_ACCESS_2_NONE_KHR};
+
+        bool operator==(const ImageState &other) const;
+
+        bool operator!=(const ImageState &other) const;
+    };
+
     class Image
     {
     public:
@@ -36,7 +57,15 @@ namespace comet
             uint32_t              num_queue_families = 0,
             const uint32_t *      queue_families     = nullptr);
 
-        ~Image() = default;
+        Image(const Image &) = delete;
+
+        Image(Image &&) = delete;
+
+        ~Image();
+
+        Image &operator=(const Image &) = delete;
+
+        Image &operator=(Image &&) = delete;
 
         Device &get_device() const;
 
@@ -48,6 +77,21 @@ namespace comet
 
         VkImageSubresource get_subresource() const;
 
+        uint32_t get_mip_levels() const;
+
+        uint32_t get_array_layers() const;
+
+        VkImageAspectFlags get_aspect_mask() const;
+
+        /// 将VK_REMAINING_MIP_LEVELS/VK_REMAINING_ARRAY_LAYERS展开为实际数量
+        VkImageSubresourceRange resolve_range(const VkImageSubresourceRange &range) const;
+
+        const ImageState &get_state(uint32_t mip_level, uint32_t array_layer) const;
+
+        void set_state(uint32_t mip_level, uint32_t array_layer, const ImageState &state);
+
+        void set_state(const VkImageSubresourceRange &range, const ImageState &state);
+
         std::unordered_set<ImageView *> &get_views();
 
     private:
@@ -71,6 +115,9 @@ namespace comet
 
 	    uint32_t m_array_layer_count{0};
 
+        /// 每个(mip, layer)子资源的状态，按layer * mip_levels + mip排列
+        std::vector<ImageState> m_states;
+
         /// Image views referring to this image
         std::unordered_set<ImageView *> m_views;
 
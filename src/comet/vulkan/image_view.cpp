@@ -58,5 +58,30 @@ ImageView::ImageView(ImageView &&other)
 
 ImageView::~ImageView()
 {
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        m_image->get_views().erase(this);
+    }
+
     vkDestroyImageView(m_device->get_handle(), m_handle, nullptr);
 }
+
+VkImageView ImageView::get_handle() const
+{
+    return m_handle;
+}
+
+Image &ImageView::get_image() const
+{
+    return *m_image;
+}
+
+VkFormat ImageView::get_format() const
+{
+    return m_format;
+}
+
+const VkImageSubresourceRange &ImageView::get_subresource_range() const
+{
+    return m_subresource_range;
+}
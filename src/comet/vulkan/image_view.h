@@ -23,6 +23,14 @@ namespace comet
 
         ImageView &operator=(ImageView &&) = delete;
 
+        VkImageView get_handle() const;
+
+        Image &get_image() const;
+
+        VkFormat get_format() const;
+
+        const VkImageSubresourceRange &get_subresource_range() const;
+
     private:
         Device *m_device{};
 
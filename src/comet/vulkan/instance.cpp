@@ -162,14 +162,36 @@ const PhysicalDevice &Instance::get_suitable_physical_device(VkSurfaceKHR surfac
     if (m_physical_devices.empty())
         throw std::runtime_error("failed to find a suitable GPU!");
 
-    // 选择独显
-    for (const auto &physical_device : m_physical_devices)
+    // 优先独显，其次集显、虚拟GPU，最后是CPU实现(如lavapipe)
+    static const std::vector<VkPhysicalDeviceType> device_type_priority = {
+        VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU,
+        VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU,
+        VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU,
+        VK_PHYSICAL_DEVICE_TYPE_CPU,
+        VK_PHYSICAL_DEVICE_TYPE_OTHER};
+
+    for (auto device_type : device_type_priority)
     {
-        if (physical_device->get_properties().deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+        for (const auto &physical_device : m_physical_devices)
         {
-            // TODO: 检查独显是否支持窗口系统表面
-            // 如果是headless模式，surface是nullptr
-            return *physical_device;
+            if (physical_device->get_properties().deviceType != device_type)
+            {
+                continue;
+            }
+
+            // headless模式下surface是nullptr，不需要检查呈现支持
+            if (surface == VK_NULL_HANDLE)
+            {
+                return *physical_device;
+            }
+
+            for (uint32_t i = 0; i < physical_device->get_queue_family_properties().size(); ++i)
+            {
+                if (physical_device->is_present_supported(surface, i))
+                {
+                    return *physical_device;
+                }
+            }
         }
     }
 
@@ -194,7 +216,7 @@ void Instance::query_physical_devices()
     // 创建物理设备对象
     for (const auto &device : devices)
     {
-        m_physical_devices.push_back(std::make_unique<PhysicalDevice>(device));
+        m_physical_devices.push_back(std::make_unique<PhysicalDevice>(*this, device));
     }
 }
 
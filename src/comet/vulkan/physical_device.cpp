@@ -2,8 +2,8 @@
 
 using namespace comet;
 
-PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device)
-    : m_handle(physical_device)
+PhysicalDevice::PhysicalDevice(Instance &instance, VkPhysicalDevice physical_device)
+    : m_instance(instance), m_handle(physical_device)
 {
     // Get the features of the GPU
     vkGetPhysicalDeviceFeatures(m_handle, &m_features);
@@ -21,6 +21,11 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device)
     vkGetPhysicalDeviceQueueFamilyProperties(m_handle, &queue_family_count, m_queue_family_properties.data());
 }
 
+Instance &PhysicalDevice::get_instance() const
+{
+    return m_instance;
+}
+
 VkPhysicalDevice PhysicalDevice::get_handle() const
 {
     return m_handle;
@@ -5,10 +5,12 @@
 
 namespace comet
 {
+    class Instance;
+
     class PhysicalDevice
     {
     public:
-        PhysicalDevice(VkPhysicalDevice physical_device);
+        PhysicalDevice(Instance &instance, VkPhysicalDevice physical_device);
 
         PhysicalDevice(const PhysicalDevice &) = delete;
 
@@ -20,6 +22,8 @@ namespace comet
 
         ~PhysicalDevice() = default;
 
+        Instance &get_instance() const;
+
         VkPhysicalDevice get_handle() const;
 
         const VkPhysicalDeviceFeatures &get_features() const;
@@ -35,6 +39,9 @@ namespace comet
         VkFormatProperties get_format_properties(VkFormat format) const;
 
     private:
+        // The instance this GPU was enumerated from
+        Instance &m_instance;
+
         VkPhysicalDevice m_handle{VK_NULL_HANDLE};
 
         // The features that this GPU supports
@@ -0,0 +1,233 @@
+#include "comet/vulkan/pipeline_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include "spdlog/spdlog.h"
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+namespace
+{
+const uint32_t CACHE_FILE_MAGIC = 0x43504C43; // "CLPC"
+
+const uint32_t CACHE_FILE_VERSION = 1;
+
+/// 文件头之后紧跟vkGetPipelineCacheData返回的数据。
+/// Vulkan自己的缓存头没有驱动版本，同一UUID的驱动升级后旧缓存也可能失效
+struct CacheFileHeader
+{
+    uint32_t magic;
+
+    uint32_t version;
+
+    uint32_t vendor_id;
+
+    uint32_t device_id;
+
+    uint32_t driver_version;
+
+    uint8_t pipeline_cache_uuid[VK_UUID_SIZE];
+
+    uint64_t data_size;
+};
+
+CacheFileHeader make_header(const VkPhysicalDeviceProperties &properties, size_t data_size)
+{
+    CacheFileHeader header{};
+    header.magic = CACHE_FILE_MAGIC;
+    header.version = CACHE_FILE_VERSION;
+    header.vendor_id = properties.vendorID;
+    header.device_id = properties.deviceID;
+    header.driver_version = properties.driverVersion;
+    std::memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    header.data_size = data_size;
+    return header;
+}
+} // namespace
+
+PipelineCache::PipelineCache(Device &device, const std::filesystem::path &path)
+    : m_device{device}, m_path{path}
+{
+    std::vector<char> file_data;
+    std::ifstream file(m_path, std::ios::binary | std::ios::ate);
+    if (file.is_open())
+    {
+        file_data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(file_data.data(), file_data.size());
+    }
+
+    VkPipelineCacheCreateInfo create_info{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    size_t data_offset = 0;
+    if (!file_data.empty())
+    {
+        if (is_compatible(file_data, data_offset))
+        {
+            create_info.initialDataSize = file_data.size() - data_offset;
+            create_info.pInitialData = file_data.data() + data_offset;
+            m_saved_size = create_info.initialDataSize;
+        }
+        else
+        {
+            spdlog::warn("pipeline cache {} was created by another device or driver, ignoring it", m_path.string());
+        }
+    }
+
+    if (vkCreatePipelineCache(m_device.get_handle(), &create_info, nullptr, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+}
+
+PipelineCache::~PipelineCache()
+{
+    for (auto worker_cache : m_worker_caches)
+    {
+        vkDestroyPipelineCache(m_device.get_handle(), worker_cache, nullptr);
+    }
+
+    vkDestroyPipelineCache(m_device.get_handle(), m_handle, nullptr);
+}
+
+VkPipelineCache PipelineCache::get_handle() const
+{
+    return m_handle;
+}
+
+VkPipelineCache PipelineCache::create_worker_cache()
+{
+    VkPipelineCacheCreateInfo create_info{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+
+    VkPipelineCache worker_cache{VK_NULL_HANDLE};
+    if (vkCreatePipelineCache(m_device.get_handle(), &create_info, nullptr, &worker_cache) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_worker_caches.push_back(worker_cache);
+
+    return worker_cache;
+}
+
+void PipelineCache::merge_worker_caches()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_worker_caches.empty())
+    {
+        return;
+    }
+
+    // 只有目标缓存需要外部同步，工作线程的缓存保留，合并重复的数据由驱动去重
+    if (vkMergePipelineCaches(m_device.get_handle(), m_handle, static_cast<uint32_t>(m_worker_caches.size()), m_worker_caches.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to merge pipeline caches!");
+    }
+}
+
+bool PipelineCache::save()
+{
+    merge_worker_caches();
+
+    size_t data_size = 0;
+    if (vkGetPipelineCacheData(m_device.get_handle(), m_handle, &data_size, nullptr) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to get pipeline cache data!");
+    }
+
+    // 缓存只增不减，大小没变就没有新的管线
+    if (data_size == m_saved_size)
+    {
+        return false;
+    }
+
+    std::vector<char> data(data_size);
+    if (vkGetPipelineCacheData(m_device.get_handle(), m_handle, &data_size, data.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to get pipeline cache data!");
+    }
+
+    auto header = make_header(m_device.get_physical_device().get_properties(), data_size);
+
+    auto temp_path = m_path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            spdlog::warn("failed to open {} for writing", temp_path.string());
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(data.data(), data_size);
+        if (!file)
+        {
+            spdlog::warn("failed to write {}", temp_path.string());
+            return false;
+        }
+    }
+
+    // 同一文件系统内的重命名是原子的，读者要么看到旧文件，要么看到完整的新文件
+    std::error_code error;
+    std::filesystem::rename(temp_path, m_path, error);
+    if (error)
+    {
+        spdlog::warn("failed to replace {}: {}", m_path.string(), error.message());
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+
+    m_saved_size = data_size;
+    return true;
+}
+
+const std::filesystem::path &PipelineCache::get_path() const
+{
+    return m_path;
+}
+
+bool PipelineCache::is_compatible(const std::vector<char> &file_data, size_t &data_offset) const
+{
+    const auto &properties = m_device.get_physical_device().get_properties();
+
+    if (file_data.size() < sizeof(CacheFileHeader))
+    {
+        return false;
+    }
+
+    CacheFileHeader header{};
+    std::memcpy(&header, file_data.data(), sizeof(header));
+    if (header.magic != CACHE_FILE_MAGIC || header.version != CACHE_FILE_VERSION ||
+        header.vendor_id != properties.vendorID || header.device_id != properties.deviceID ||
+        header.driver_version != properties.driverVersion ||
+        std::memcmp(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0 ||
+        header.data_size != file_data.size() - sizeof(header))
+    {
+        return false;
+    }
+
+    // 驱动自己的缓存头也要一致，驱动遇到不匹配的数据会忽略，这里提前拒绝并给出提示
+    if (header.data_size < sizeof(VkPipelineCacheHeaderVersionOne))
+    {
+        return false;
+    }
+
+    VkPipelineCacheHeaderVersionOne cache_header{};
+    std::memcpy(&cache_header, file_data.data() + sizeof(header), sizeof(cache_header));
+    if (cache_header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) ||
+        cache_header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        cache_header.vendorID != properties.vendorID || cache_header.deviceID != properties.deviceID ||
+        std::memcmp(cache_header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        return false;
+    }
+
+    data_offset = sizeof(header);
+    return true;
+}
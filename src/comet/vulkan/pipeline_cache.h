@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+#include "volk.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 持久化到磁盘的管线缓存。文件头记录厂商、设备ID、驱动版本和pipelineCacheUUID，
+    /// 与当前设备不一致(换了显卡或升级了驱动)时丢弃旧数据，从空缓存开始
+    class PipelineCache
+    {
+    public:
+        /// 从path加载缓存，文件不存在或校验失败时创建空缓存
+        PipelineCache(Device &device, const std::filesystem::path &path);
+
+        PipelineCache(const PipelineCache &) = delete;
+
+        PipelineCache(PipelineCache &&) = delete;
+
+        /// 不会自动保存
+        ~PipelineCache();
+
+        PipelineCache &operator=(const PipelineCache &) = delete;
+
+        PipelineCache &operator=(PipelineCache &&) = delete;
+
+        /// 传给vkCreate*Pipelines的句柄
+        VkPipelineCache get_handle() const;
+
+        /// 给编译线程单独使用的空缓存，避免多个线程争用同一个缓存的内部锁。
+        /// 在PipelineCache销毁前一直有效
+        VkPipelineCache create_worker_cache();
+
+        /// 把所有工作线程的缓存合并进主缓存。工作线程可以继续使用它们的缓存，
+        /// 但主缓存不能同时被其他线程用来创建管线
+        void merge_worker_caches();
+
+        /// 合并工作线程的缓存后写到磁盘：先写临时文件再重命名，中途退出不会留下损坏的文件。
+        /// 数据大小与上次保存相同时跳过，可以定期调用，返回是否写入
+        bool save();
+
+        const std::filesystem::path &get_path() const;
+
+    private:
+        bool is_compatible(const std::vector<char> &file_data, size_t &data_offset) const;
+
+    private:
+        Device &m_device;
+
+        std::filesystem::path m_path;
+
+        VkPipelineCache m_handle{VK_NULL_HANDLE};
+
+        std::mutex m_mutex;
+
+        std::vector<VkPipelineCache> m_worker_caches;
+
+        /// 上次加载或保存时的数据大小
+        size_t m_saved_size{0};
+    };
+} // namespace comet
@@ -0,0 +1,54 @@
+#include "comet/vulkan/pipeline_layout.h"
+
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+PipelineLayout::PipelineLayout(const Device &device, const std::vector<std::shared_ptr<DescriptorSetLayout>> &set_layouts,
+                               const std::vector<VkPushConstantRange> &push_constant_ranges)
+    : m_device(device), m_set_layouts(set_layouts), m_push_constant_ranges(push_constant_ranges)
+{
+    std::vector<VkDescriptorSetLayout> handles;
+    handles.reserve(m_set_layouts.size());
+    for (const auto &set_layout : m_set_layouts)
+    {
+        handles.push_back(set_layout->get_handle());
+    }
+
+    VkPipelineLayoutCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    info.setLayoutCount = static_cast<uint32_t>(handles.size());
+    info.pSetLayouts = handles.data();
+    info.pushConstantRangeCount = static_cast<uint32_t>(m_push_constant_ranges.size());
+    info.pPushConstantRanges = m_push_constant_ranges.data();
+
+    if (vkCreatePipelineLayout(m_device.get_handle(), &info, nullptr, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline layout!");
+    }
+}
+
+PipelineLayout::~PipelineLayout()
+{
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(m_device.get_handle(), m_handle, nullptr);
+    }
+}
+
+VkPipelineLayout PipelineLayout::get_handle() const
+{
+    return m_handle;
+}
+
+const std::vector<std::shared_ptr<DescriptorSetLayout>> &PipelineLayout::get_set_layouts() const
+{
+    return m_set_layouts;
+}
+
+const std::vector<VkPushConstantRange> &PipelineLayout::get_push_constant_ranges() const
+{
+    return m_push_constant_ranges;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/descriptor_set_layout.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 持有使用的描述符集布局，保证它们比管线布局活得久
+    class PipelineLayout
+    {
+    public:
+        PipelineLayout(const Device &device, const std::vector<std::shared_ptr<DescriptorSetLayout>> &set_layouts,
+                       const std::vector<VkPushConstantRange> &push_constant_ranges);
+
+        PipelineLayout(const PipelineLayout &) = delete;
+
+        PipelineLayout(PipelineLayout &&) = delete;
+
+        ~PipelineLayout();
+
+        PipelineLayout &operator=(const PipelineLayout &) = delete;
+
+        PipelineLayout &operator=(PipelineLayout &&) = delete;
+
+        VkPipelineLayout get_handle() const;
+
+        const std::vector<std::shared_ptr<DescriptorSetLayout>> &get_set_layouts() const;
+
+        const std::vector<VkPushConstantRange> &get_push_constant_ranges() const;
+
+    private:
+        const Device &m_device;
+
+        VkPipelineLayout m_handle{VK_NULL_HANDLE};
+
+        std::vector<std::shared_ptr<DescriptorSetLayout>> m_set_layouts;
+
+        std::vector<VkPushConstantRange> m_push_constant_ranges;
+    };
+} // namespace comet
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include "volk.h"
+
+namespace comet
+{
+    /// 交换链的获取/呈现接口，窗口交换链和离屏模拟的交换链都实现它，
+    /// 渲染循环只依赖这个接口
+    class Presenter
+    {
+    public:
+        virtual ~Presenter() = default;
+
+        /// 获取下一张可用图像，图像可用时触发image_acquired_semaphore和fence
+        virtual VkResult acquire_next_image(uint32_t &image_index, VkSemaphore image_acquired_semaphore, VkFence fence = VK_NULL_HANDLE) = 0;
+
+        /// 等待wait_semaphore后呈现image_index
+        virtual VkResult present(VkQueue queue, uint32_t image_index, VkSemaphore wait_semaphore) = 0;
+
+        virtual const std::vector<VkImage> &get_images() const = 0;
+
+        virtual VkFormat get_format() const = 0;
+
+        virtual const VkExtent2D &get_extent() const = 0;
+
+        virtual VkImageUsageFlags get_usage() const = 0;
+
+        /// 呈现时图像需要处于的布局
+        virtual VkImageLayout get_present_layout() const = 0;
+    };
+} // namespace comet
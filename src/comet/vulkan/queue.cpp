@@ -1,5 +1,7 @@
 #include "comet/vulkan/queue.h"
 
+#include <stdexcept>
+
 #include "comet/vulkan/device.h"
 #include "vulkan/vulkan_core.h"
 
@@ -9,10 +11,39 @@ Queue::Queue(Device &device, uint32_t family_index, VkQueueFamilyProperties prop
     : m_device(device), m_family_index(family_index), m_properties(properties), m_can_present(can_present), m_index(index)
 {
     vkGetDeviceQueue(m_device.get_handle(), m_family_index, m_index, &m_handle);
+
+    VkSemaphoreTypeCreateInfo type_info{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_info.initialValue = 0;
+
+    VkSemaphoreCreateInfo create_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    create_info.pNext = &type_info;
+    if (vkCreateSemaphore(m_device.get_handle(), &create_info, nullptr, &m_timeline_semaphore) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create queue timeline semaphore!");
+    }
+}
+
+Queue::Queue(Queue &&other)
+    : m_device(other.m_device),
+      m_handle(other.m_handle),
+      m_family_index(other.m_family_index),
+      m_index(other.m_index),
+      m_can_present(other.m_can_present),
+      m_properties(other.m_properties),
+      m_timeline_semaphore(other.m_timeline_semaphore),
+      m_last_submitted_value(other.m_last_submitted_value.load()),
+      m_completed_value(other.m_completed_value.load())
+{
+    other.m_timeline_semaphore = VK_NULL_HANDLE;
 }
 
 Queue::~Queue()
 {
+    if (m_timeline_semaphore != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(m_device.get_handle(), m_timeline_semaphore, nullptr);
+    }
 }
 
 VkQueue Queue::get_handle() const
@@ -20,6 +51,11 @@ VkQueue Queue::get_handle() const
     return m_handle;
 }
 
+uint32_t Queue::get_family_index() const
+{
+    return m_family_index;
+}
+
 const VkQueueFamilyProperties &Queue::get_properties() const
 {
 	return m_properties;
@@ -28,4 +64,129 @@ const VkQueueFamilyProperties &Queue::get_properties() const
 VkBool32 Queue::support_present() const
 {
 	return m_can_present;
-}
\ No newline at end of file
+}
+
+uint64_t Queue::submit(const std::vector<VkCommandBuffer> &command_buffers,
+                       const std::vector<VkSemaphore> &wait_semaphores,
+                       const std::vector<VkPipelineStageFlags> &wait_stages,
+                       const std::vector<VkSemaphore> &signal_semaphores,
+                       const std::vector<TimelineWait> &timeline_waits,
+                       VkFence fence)
+{
+    if (wait_semaphores.size() != wait_stages.size())
+    {
+        throw std::runtime_error("each wait semaphore needs a wait stage!");
+    }
+
+    std::lock_guard<std::mutex> lock{m_submit_mutex};
+
+    uint64_t value = m_last_submitted_value.load() + 1;
+
+    // 时间线信号量放在最后，二值信号量对应的值会被忽略
+    std::vector<VkSemaphore> signals{signal_semaphores};
+    signals.push_back(m_timeline_semaphore);
+    std::vector<uint64_t> signal_values(signals.size(), 0);
+    signal_values.back() = value;
+    std::vector<VkSemaphore> waits{wait_semaphores};
+    std::vector<VkPipelineStageFlags> stages{wait_stages};
+    std::vector<uint64_t> wait_values(waits.size(), 0);
+    for (const auto &timeline_wait : timeline_waits)
+    {
+        // 已经完成的值不需要让GPU等待
+        if (timeline_wait.queue->is_complete(timeline_wait.value))
+        {
+            continue;
+        }
+        waits.push_back(timeline_wait.queue->get_timeline_semaphore());
+        stages.push_back(timeline_wait.stage_mask);
+        wait_values.push_back(timeline_wait.value);
+    }
+
+    VkTimelineSemaphoreSubmitInfo timeline_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+    timeline_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+    timeline_info.pWaitSemaphoreValues = wait_values.data();
+    timeline_info.signalSemaphoreValueCount = static_cast<uint32_t>(signal_values.size());
+    timeline_info.pSignalSemaphoreValues = signal_values.data();
+
+    VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submit_info.pNext = &timeline_info;
+    submit_info.waitSemaphoreCount = static_cast<uint32_t>(waits.size());
+    submit_info.pWaitSemaphores = waits.data();
+    submit_info.pWaitDstStageMask = stages.data();
+    submit_info.commandBufferCount = static_cast<uint32_t>(command_buffers.size());
+    submit_info.pCommandBuffers = command_buffers.data();
+    submit_info.signalSemaphoreCount = static_cast<uint32_t>(signals.size());
+    submit_info.pSignalSemaphores = signals.data();
+
+    if (vkQueueSubmit(m_handle, 1, &submit_info, fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit to queue!");
+    }
+
+    m_last_submitted_value.store(value);
+    return value;
+}
+
+uint64_t Queue::get_last_submitted_value() const
+{
+    return m_last_submitted_value.load();
+}
+
+uint64_t Queue::get_completed_value() const
+{
+    uint64_t value = 0;
+    if (vkGetSemaphoreCounterValue(m_device.get_handle(), m_timeline_semaphore, &value) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to query queue timeline semaphore!");
+    }
+
+    // 只会增大，并发更新时保留较大的值
+    uint64_t cached = m_completed_value.load();
+    while (cached < value && !m_completed_value.compare_exchange_weak(cached, value))
+    {
+    }
+
+    return value;
+}
+
+bool Queue::is_complete(uint64_t value) const
+{
+    if (value <= m_completed_value.load())
+    {
+        return true;
+    }
+
+    return value <= get_completed_value();
+}
+
+void Queue::wait(uint64_t value) const
+{
+    if (is_complete(value))
+    {
+        return;
+    }
+
+    VkSemaphoreWaitInfo wait_info{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+    wait_info.semaphoreCount = 1;
+    wait_info.pSemaphores = &m_timeline_semaphore;
+    wait_info.pValues = &value;
+    if (vkWaitSemaphores(m_device.get_handle(), &wait_info, UINT64_MAX) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to wait for queue timeline semaphore!");
+    }
+
+    uint64_t cached = m_completed_value.load();
+    while (cached < value && !m_completed_value.compare_exchange_weak(cached, value))
+    {
+    }
+}
+
+void Queue::wait_idle() const
+{
+    wait(m_last_submitted_value.load());
+}
+
+VkSemaphore Queue::get_timeline_semaphore() const
+{
+    return m_timeline_semaphore;
+}
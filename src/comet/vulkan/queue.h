@@ -1,23 +1,80 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
 #include "volk.h"
 
 namespace comet
 {
     class Device;
 
+    class Queue;
+
+    /// 等待另一个队列时间线上的值，用于跨队列的依赖(如异步计算)
+    struct TimelineWait
+    {
+        const Queue *queue;
+
+        uint64_t value;
+
+        VkPipelineStageFlags stage_mask;
+    };
+
+    /// 每个队列持有一个时间线信号量，每次submit让它加一。
+    /// "某次提交是否完成"只需比较整数，CPU也可以等待任意一次提交
     class Queue
     {
         public:
             Queue(Device &device, uint32_t family_index, VkQueueFamilyProperties properties, VkBool32 can_present, uint32_t index);
+
+            Queue(const Queue &) = delete;
+
+            Queue(Queue &&other);
+
             ~Queue();
 
+            Queue &operator=(const Queue &) = delete;
+
+            Queue &operator=(Queue &&) = delete;
+
             VkQueue get_handle() const;
 
+            uint32_t get_family_index() const;
+
             const VkQueueFamilyProperties &get_properties() const;
 
             VkBool32 support_present() const;
 
+            /// 提交命令缓冲，返回这次提交完成时时间线信号量的值。
+            /// wait_semaphores/signal_semaphores只能是二值信号量(如交换链的获取/呈现信号量)，
+            /// 其他队列的时间线通过timeline_waits等待
+            uint64_t submit(const std::vector<VkCommandBuffer> &command_buffers,
+                            const std::vector<VkSemaphore> &wait_semaphores = {},
+                            const std::vector<VkPipelineStageFlags> &wait_stages = {},
+                            const std::vector<VkSemaphore> &signal_semaphores = {},
+                            const std::vector<TimelineWait> &timeline_waits = {},
+                            VkFence fence = VK_NULL_HANDLE);
+
+            /// 最近一次提交的值，还没有提交过时为0
+            uint64_t get_last_submitted_value() const;
+
+            /// GPU已经完成的值
+            uint64_t get_completed_value() const;
+
+            /// value之前(含)的提交是否都已完成，value为0时总是完成
+            bool is_complete(uint64_t value) const;
+
+            /// 在CPU上等待value对应的提交完成
+            void wait(uint64_t value) const;
+
+            /// 等待目前为止的所有提交完成
+            void wait_idle() const;
+
+            VkSemaphore get_timeline_semaphore() const;
+
         private:
             const Device& m_device;
 
@@ -31,5 +88,15 @@ namespace comet
 
             VkQueueFamilyProperties m_properties;
 
+            VkSemaphore m_timeline_semaphore{VK_NULL_HANDLE};
+
+            /// 提交需要外部同步，保护m_last_submitted_value和vkQueueSubmit
+            std::mutex m_submit_mutex;
+
+            std::atomic<uint64_t> m_last_submitted_value{0};
+
+            /// 缓存的已完成值，已经完成的查询不需要再调用驱动
+            mutable std::atomic<uint64_t> m_completed_value{0};
+
     }; // class Queue
-} // namespace comet
\ No newline at end of file
+} // namespace comet
@@ -0,0 +1,106 @@
+#include "comet/vulkan/render_pass.h"
+
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+namespace
+{
+VkAttachmentDescription to_description(const RenderPassAttachment &attachment)
+{
+    VkAttachmentDescription description{};
+    description.format = attachment.format;
+    description.samples = attachment.samples;
+    description.loadOp = attachment.load_op;
+    description.storeOp = attachment.store_op;
+    // 模板与深度使用相同的操作，没有模板的格式会忽略
+    description.stencilLoadOp = attachment.load_op;
+    description.stencilStoreOp = attachment.store_op;
+    description.initialLayout = attachment.initial_layout;
+    description.finalLayout = attachment.final_layout;
+    return description;
+}
+} // namespace
+
+bool RenderPassAttachment::operator==(const RenderPassAttachment &other) const
+{
+    return format == other.format &&
+           samples == other.samples &&
+           load_op == other.load_op &&
+           store_op == other.store_op &&
+           initial_layout == other.initial_layout &&
+           final_layout == other.final_layout;
+}
+
+bool RenderPassDesc::operator==(const RenderPassDesc &other) const
+{
+    return color_attachments == other.color_attachments && depth_attachment == other.depth_attachment;
+}
+
+RenderPass::RenderPass(const Device &device, const RenderPassDesc &desc)
+    : m_device(device), m_desc(desc)
+{
+    std::vector<VkAttachmentDescription> attachments;
+    std::vector<VkAttachmentReference> color_references;
+    for (const auto &attachment : m_desc.color_attachments)
+    {
+        color_references.push_back({static_cast<uint32_t>(attachments.size()), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+        attachments.push_back(to_description(attachment));
+    }
+
+    VkAttachmentReference depth_reference{VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED};
+    if (m_desc.depth_attachment)
+    {
+        depth_reference = {static_cast<uint32_t>(attachments.size()), VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+        attachments.push_back(to_description(*m_desc.depth_attachment));
+    }
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = static_cast<uint32_t>(color_references.size());
+    subpass.pColorAttachments = color_references.data();
+    subpass.pDepthStencilAttachment = m_desc.depth_attachment ? &depth_reference : nullptr;
+
+    // 清除和写入附件之前等待之前对附件的使用
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.srcAccessMask = 0;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    VkRenderPassCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    create_info.attachmentCount = static_cast<uint32_t>(attachments.size());
+    create_info.pAttachments = attachments.data();
+    create_info.subpassCount = 1;
+    create_info.pSubpasses = &subpass;
+    create_info.dependencyCount = 1;
+    create_info.pDependencies = &dependency;
+
+    if (vkCreateRenderPass(m_device.get_handle(), &create_info, nullptr, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create render pass!");
+    }
+}
+
+RenderPass::~RenderPass()
+{
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        vkDestroyRenderPass(m_device.get_handle(), m_handle, nullptr);
+    }
+}
+
+VkRenderPass RenderPass::get_handle() const
+{
+    return m_handle;
+}
+
+const RenderPassDesc &RenderPass::get_desc() const
+{
+    return m_desc;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "volk.h"
+
+namespace comet
+{
+    class Device;
+
+    struct RenderPassAttachment
+    {
+        VkFormat format{VK_FORMAT_UNDEFINED};
+
+        VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+
+        VkAttachmentLoadOp load_op{VK_ATTACHMENT_LOAD_OP_CLEAR};
+
+        VkAttachmentStoreOp store_op{VK_ATTACHMENT_STORE_OP_STORE};
+
+        VkImageLayout initial_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+        VkImageLayout final_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+        bool operator==(const RenderPassAttachment &other) const;
+    };
+
+    /// 只有一个子通道的渲染通道，布局转换一般由屏障完成，
+    /// initial_layout和final_layout与子通道中的布局相同时渲染通道不做转换
+    struct RenderPassDesc
+    {
+        std::vector<RenderPassAttachment> color_attachments;
+
+        /// 深度模板附件排在所有颜色附件之后
+        std::optional<RenderPassAttachment> depth_attachment;
+
+        bool operator==(const RenderPassDesc &other) const;
+    };
+
+    class RenderPass
+    {
+    public:
+        RenderPass(const Device &device, const RenderPassDesc &desc);
+
+        RenderPass(const RenderPass &) = delete;
+
+        RenderPass(RenderPass &&) = delete;
+
+        ~RenderPass();
+
+        RenderPass &operator=(const RenderPass &) = delete;
+
+        RenderPass &operator=(RenderPass &&) = delete;
+
+        VkRenderPass get_handle() const;
+
+        const RenderPassDesc &get_desc() const;
+
+    private:
+        const Device &m_device;
+
+        VkRenderPass m_handle{VK_NULL_HANDLE};
+
+        RenderPassDesc m_desc;
+    };
+} // namespace comet
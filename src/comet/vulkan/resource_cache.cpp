@@ -0,0 +1,474 @@
+#include "comet/vulkan/resource_cache.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "comet/core/hash.h"
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+bool ResourceCache::ImageViewKey::operator==(const ImageViewKey &other) const
+{
+    return image == other.image &&
+           view_type == other.view_type &&
+           format == other.format &&
+           subresource_range.aspectMask == other.subresource_range.aspectMask &&
+           subresource_range.baseMipLevel == other.subresource_range.baseMipLevel &&
+           subresource_range.levelCount == other.subresource_range.levelCount &&
+           subresource_range.baseArrayLayer == other.subresource_range.baseArrayLayer &&
+           subresource_range.layerCount == other.subresource_range.layerCount;
+}
+
+size_t ResourceCache::ImageViewKeyHash::operator()(const ImageViewKey &key) const
+{
+    size_t seed = 0;
+    hash_combine(seed, key.image);
+    hash_combine(seed, static_cast<uint32_t>(key.view_type));
+    hash_combine(seed, static_cast<uint32_t>(key.format));
+    hash_combine(seed, key.subresource_range.aspectMask);
+    hash_combine(seed, key.subresource_range.baseMipLevel);
+    hash_combine(seed, key.subresource_range.levelCount);
+    hash_combine(seed, key.subresource_range.baseArrayLayer);
+    hash_combine(seed, key.subresource_range.layerCount);
+    return seed;
+}
+
+bool ResourceCache::SamplerKey::operator==(const SamplerKey &other) const
+{
+    const auto &a = info;
+    const auto &b = other.info;
+    return a.flags == b.flags &&
+           a.magFilter == b.magFilter &&
+           a.minFilter == b.minFilter &&
+           a.mipmapMode == b.mipmapMode &&
+           a.addressModeU == b.addressModeU &&
+           a.addressModeV == b.addressModeV &&
+           a.addressModeW == b.addressModeW &&
+           a.mipLodBias == b.mipLodBias &&
+           a.anisotropyEnable == b.anisotropyEnable &&
+           a.maxAnisotropy == b.maxAnisotropy &&
+           a.compareEnable == b.compareEnable &&
+           a.compareOp == b.compareOp &&
+           a.minLod == b.minLod &&
+           a.maxLod == b.maxLod &&
+           a.borderColor == b.borderColor &&
+           a.unnormalizedCoordinates == b.unnormalizedCoordinates;
+}
+
+size_t ResourceCache::SamplerKeyHash::operator()(const SamplerKey &key) const
+{
+    const auto &info = key.info;
+    size_t seed = 0;
+    hash_combine(seed, info.flags);
+    hash_combine(seed, static_cast<uint32_t>(info.magFilter));
+    hash_combine(seed, static_cast<uint32_t>(info.minFilter));
+    hash_combine(seed, static_cast<uint32_t>(info.mipmapMode));
+    hash_combine(seed, static_cast<uint32_t>(info.addressModeU));
+    hash_combine(seed, static_cast<uint32_t>(info.addressModeV));
+    hash_combine(seed, static_cast<uint32_t>(info.addressModeW));
+    hash_combine(seed, info.mipLodBias);
+    hash_combine(seed, info.anisotropyEnable);
+    hash_combine(seed, info.maxAnisotropy);
+    hash_combine(seed, info.compareEnable);
+    hash_combine(seed, static_cast<uint32_t>(info.compareOp));
+    hash_combine(seed, info.minLod);
+    hash_combine(seed, info.maxLod);
+    hash_combine(seed, static_cast<uint32_t>(info.borderColor));
+    hash_combine(seed, info.unnormalizedCoordinates);
+    return seed;
+}
+
+bool ResourceCache::DescriptorSetLayoutKey::operator==(const DescriptorSetLayoutKey &other) const
+{
+    return std::equal(bindings.begin(), bindings.end(), other.bindings.begin(), other.bindings.end(),
+                      [](const VkDescriptorSetLayoutBinding &a, const VkDescriptorSetLayoutBinding &b)
+                      {
+                          return a.binding == b.binding &&
+                                 a.descriptorType == b.descriptorType &&
+                                 a.descriptorCount == b.descriptorCount &&
+                                 a.stageFlags == b.stageFlags;
+                      });
+}
+
+size_t ResourceCache::DescriptorSetLayoutKeyHash::operator()(const DescriptorSetLayoutKey &key) const
+{
+    size_t seed = 0;
+    for (const auto &binding : key.bindings)
+    {
+        hash_combine(seed, binding.binding);
+        hash_combine(seed, static_cast<uint32_t>(binding.descriptorType));
+        hash_combine(seed, binding.descriptorCount);
+        hash_combine(seed, binding.stageFlags);
+    }
+    return seed;
+}
+
+bool ResourceCache::PipelineLayoutKey::operator==(const PipelineLayoutKey &other) const
+{
+    return set_layouts == other.set_layouts &&
+           std::equal(push_constant_ranges.begin(), push_constant_ranges.end(),
+                      other.push_constant_ranges.begin(), other.push_constant_ranges.end(),
+                      [](const VkPushConstantRange &a, const VkPushConstantRange &b)
+                      {
+                          return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+                      });
+}
+
+size_t ResourceCache::PipelineLayoutKeyHash::operator()(const PipelineLayoutKey &key) const
+{
+    size_t seed = 0;
+    for (auto set_layout : key.set_layouts)
+    {
+        hash_combine(seed, set_layout);
+    }
+    for (const auto &range : key.push_constant_ranges)
+    {
+        hash_combine(seed, range.stageFlags);
+        hash_combine(seed, range.offset);
+        hash_combine(seed, range.size);
+    }
+    return seed;
+}
+
+size_t ResourceCache::RenderPassKeyHash::operator()(const RenderPassDesc &desc) const
+{
+    auto hash_attachment = [](size_t &seed, const RenderPassAttachment &attachment)
+    {
+        hash_combine(seed, static_cast<uint32_t>(attachment.format));
+        hash_combine(seed, static_cast<uint32_t>(attachment.samples));
+        hash_combine(seed, static_cast<uint32_t>(attachment.load_op));
+        hash_combine(seed, static_cast<uint32_t>(attachment.store_op));
+        hash_combine(seed, static_cast<uint32_t>(attachment.initial_layout));
+        hash_combine(seed, static_cast<uint32_t>(attachment.final_layout));
+    };
+
+    size_t seed = 0;
+    for (const auto &attachment : desc.color_attachments)
+    {
+        hash_attachment(seed, attachment);
+    }
+    hash_combine(seed, desc.depth_attachment.has_value());
+    if (desc.depth_attachment)
+    {
+        hash_attachment(seed, *desc.depth_attachment);
+    }
+    return seed;
+}
+
+bool ResourceCache::FramebufferKey::operator==(const FramebufferKey &other) const
+{
+    return render_pass == other.render_pass &&
+           attachments == other.attachments &&
+           extent.width == other.extent.width &&
+           extent.height == other.extent.height &&
+           layers == other.layers;
+}
+
+size_t ResourceCache::FramebufferKeyHash::operator()(const FramebufferKey &key) const
+{
+    size_t seed = 0;
+    hash_combine(seed, key.render_pass);
+    for (auto attachment : key.attachments)
+    {
+        hash_combine(seed, attachment);
+    }
+    hash_combine(seed, key.extent.width);
+    hash_combine(seed, key.extent.height);
+    hash_combine(seed, key.layers);
+    return seed;
+}
+
+ResourceCache::ResourceCache(Device &device)
+    : m_device(device)
+{
+}
+
+std::shared_ptr<ImageView> ResourceCache::request_image_view(Image &image, VkImageViewType view_type, VkFormat format,
+                                                             uint32_t base_mip_level, uint32_t base_array_layer,
+                                                             uint32_t n_mip_levels, uint32_t n_array_layers)
+{
+    // 与ImageView构造函数相同的规则补全参数，保证等价的请求得到相同的键
+    ImageViewKey key{};
+    key.image = &image;
+    key.view_type = view_type;
+    key.format = format == VK_FORMAT_UNDEFINED ? image.get_format() : format;
+    key.subresource_range.baseMipLevel = base_mip_level;
+    key.subresource_range.baseArrayLayer = base_array_layer;
+    key.subresource_range.levelCount = n_mip_levels == 0 ? image.get_mip_levels() : n_mip_levels;
+    key.subresource_range.layerCount = n_array_layers == 0 ? image.get_array_layers() : n_array_layers;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_image_views.find(key);
+    if (found != m_image_views.end())
+    {
+        if (auto view = found->second.lock())
+        {
+            return view;
+        }
+    }
+
+    auto view = std::make_shared<ImageView>(image, view_type, key.format,
+                                            key.subresource_range.baseMipLevel, key.subresource_range.baseArrayLayer,
+                                            key.subresource_range.levelCount, key.subresource_range.layerCount);
+    m_image_views[key] = view;
+
+    prune_if_needed();
+
+    return view;
+}
+
+std::shared_ptr<Sampler> ResourceCache::request_sampler(const VkSamplerCreateInfo &info)
+{
+    if (info.pNext != nullptr)
+    {
+        throw std::runtime_error("sampler create info with pNext chain can not be cached!");
+    }
+
+    SamplerKey key{info};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_samplers.find(key);
+    if (found != m_samplers.end())
+    {
+        if (auto sampler = found->second.lock())
+        {
+            return sampler;
+        }
+    }
+
+    auto sampler = std::make_shared<Sampler>(m_device, info);
+    m_samplers[key] = sampler;
+
+    prune_if_needed();
+
+    return sampler;
+}
+
+std::shared_ptr<DescriptorSetLayout> ResourceCache::request_descriptor_set_layout(const std::vector<VkDescriptorSetLayoutBinding> &bindings)
+{
+    DescriptorSetLayoutKey key{bindings};
+    for (const auto &binding : key.bindings)
+    {
+        if (binding.pImmutableSamplers != nullptr)
+        {
+            throw std::runtime_error("descriptor set layout with immutable samplers can not be cached!");
+        }
+    }
+    // 绑定的声明顺序不影响布局
+    std::sort(key.bindings.begin(), key.bindings.end(), [](const VkDescriptorSetLayoutBinding &a, const VkDescriptorSetLayoutBinding &b)
+              { return a.binding < b.binding; });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_descriptor_set_layouts.find(key);
+    if (found != m_descriptor_set_layouts.end())
+    {
+        if (auto set_layout = found->second.lock())
+        {
+            return set_layout;
+        }
+    }
+
+    auto set_layout = std::make_shared<DescriptorSetLayout>(m_device, key.bindings);
+    m_descriptor_set_layouts[key] = set_layout;
+
+    prune_if_needed();
+
+    return set_layout;
+}
+
+std::shared_ptr<PipelineLayout> ResourceCache::request_pipeline_layout(const std::vector<std::shared_ptr<DescriptorSetLayout>> &set_layouts,
+                                                                       const std::vector<VkPushConstantRange> &push_constant_ranges)
+{
+    PipelineLayoutKey key{};
+    key.push_constant_ranges = push_constant_ranges;
+    for (const auto &set_layout : set_layouts)
+    {
+        key.set_layouts.push_back(set_layout->get_handle());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_pipeline_layouts.find(key);
+    if (found != m_pipeline_layouts.end())
+    {
+        if (auto pipeline_layout = found->second.lock())
+        {
+            return pipeline_layout;
+        }
+    }
+
+    auto pipeline_layout = std::make_shared<PipelineLayout>(m_device, set_layouts, push_constant_ranges);
+    m_pipeline_layouts[key] = pipeline_layout;
+
+    prune_if_needed();
+
+    return pipeline_layout;
+}
+
+std::shared_ptr<PipelineLayout> ResourceCache::request_pipeline_layout(const ShaderReflection &reflection)
+{
+    std::vector<std::shared_ptr<DescriptorSetLayout>> set_layouts;
+    for (uint32_t set = 0; set < reflection.get_set_count(); ++set)
+    {
+        set_layouts.push_back(request_descriptor_set_layout(reflection.get_set_layout_bindings(set)));
+    }
+
+    return request_pipeline_layout(set_layouts, reflection.get_push_constant_ranges());
+}
+
+std::shared_ptr<RenderPass> ResourceCache::request_render_pass(const RenderPassDesc &desc)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_render_passes.find(desc);
+    if (found != m_render_passes.end())
+    {
+        if (auto render_pass = found->second.lock())
+        {
+            return render_pass;
+        }
+    }
+
+    auto render_pass = std::make_shared<RenderPass>(m_device, desc);
+    m_render_passes[desc] = render_pass;
+
+    prune_if_needed();
+
+    return render_pass;
+}
+
+std::shared_ptr<Framebuffer> ResourceCache::request_framebuffer(const std::shared_ptr<RenderPass> &render_pass,
+                                                                const std::vector<std::shared_ptr<ImageView>> &attachments,
+                                                                VkExtent2D extent, uint32_t layers)
+{
+    FramebufferKey key{};
+    key.render_pass = render_pass->get_handle();
+    for (const auto &attachment : attachments)
+    {
+        key.attachments.push_back(attachment->get_handle());
+    }
+    key.extent = extent;
+    key.layers = layers;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_framebuffers.find(key);
+    if (found != m_framebuffers.end())
+    {
+        if (auto framebuffer = found->second.lock())
+        {
+            return framebuffer;
+        }
+    }
+
+    auto framebuffer = std::make_shared<Framebuffer>(m_device, render_pass, attachments, extent, layers);
+    m_framebuffers[key] = framebuffer;
+
+    prune_if_needed();
+
+    return framebuffer;
+}
+
+void ResourceCache::prune()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    remove_expired();
+}
+
+size_t ResourceCache::get_image_view_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_image_views.begin(), m_image_views.end(), [](const auto &entry)
+                         { return !entry.second.expired(); });
+}
+
+size_t ResourceCache::get_sampler_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_samplers.begin(), m_samplers.end(), [](const auto &entry)
+                         { return !entry.second.expired(); });
+}
+
+size_t ResourceCache::get_descriptor_set_layout_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_descriptor_set_layouts.begin(), m_descriptor_set_layouts.end(), [](const auto &entry)
+                         { return !entry.second.expired(); });
+}
+
+size_t ResourceCache::get_pipeline_layout_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_pipeline_layouts.begin(), m_pipeline_layouts.end(), [](const auto &entry)
+                         { return !entry.second.expired(); });
+}
+
+size_t ResourceCache::get_render_pass_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_render_passes.begin(), m_render_passes.end(), [](const auto &entry)
+                         { return !entry.second.expired(); });
+}
+
+size_t ResourceCache::get_framebuffer_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_framebuffers.begin(), m_framebuffers.end(), [](const auto &entry)
+                         { return !entry.second.expired(); });
+}
+
+size_t ResourceCache::get_entry_count() const
+{
+    return m_image_views.size() + m_samplers.size() + m_descriptor_set_layouts.size() + m_pipeline_layouts.size() +
+           m_render_passes.size() + m_framebuffers.size();
+}
+
+void ResourceCache::prune_if_needed()
+{
+    if (get_entry_count() < m_prune_threshold)
+    {
+        return;
+    }
+
+    remove_expired();
+
+    m_prune_threshold = std::max<size_t>(64, 2 * get_entry_count());
+}
+
+void ResourceCache::remove_expired()
+{
+    for (auto it = m_image_views.begin(); it != m_image_views.end();)
+    {
+        it = it->second.expired() ? m_image_views.erase(it) : std::next(it);
+    }
+
+    for (auto it = m_samplers.begin(); it != m_samplers.end();)
+    {
+        it = it->second.expired() ? m_samplers.erase(it) : std::next(it);
+    }
+
+    for (auto it = m_descriptor_set_layouts.begin(); it != m_descriptor_set_layouts.end();)
+    {
+        it = it->second.expired() ? m_descriptor_set_layouts.erase(it) : std::next(it);
+    }
+
+    for (auto it = m_pipeline_layouts.begin(); it != m_pipeline_layouts.end();)
+    {
+        it = it->second.expired() ? m_pipeline_layouts.erase(it) : std::next(it);
+    }
+
+    for (auto it = m_render_passes.begin(); it != m_render_passes.end();)
+    {
+        it = it->second.expired() ? m_render_passes.erase(it) : std::next(it);
+    }
+
+    for (auto it = m_framebuffers.begin(); it != m_framebuffers.end();)
+    {
+        it = it->second.expired() ? m_framebuffers.erase(it) : std::next(it);
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "volk.h"
+
+#include "comet/vulkan/image.h"
+#include "comet/vulkan/image_view.h"
+#include "comet/vulkan/sampler.h"
+#include "comet/vulkan/descriptor_set_layout.h"
+#include "comet/vulkan/pipeline_layout.h"
+#include "comet/vulkan/shader_reflection.h"
+#include "comet/vulkan/render_pass.h"
+#include "comet/vulkan/framebuffer.h"
+
+namespace comet
+{
+    class Device;
+
+    /// 按创建参数去重的图像视图、采样器、描述符集布局、管线布局、渲染通道和帧缓冲缓存
+    /// 返回的shared_ptr就是引用计数，最后一个引用释放时对象被销毁，缓存中只保留weak_ptr
+    class ResourceCache
+    {
+    public:
+        ResourceCache(Device &device);
+
+        ResourceCache(const ResourceCache &) = delete;
+
+        ResourceCache(ResourceCache &&) = delete;
+
+        ~ResourceCache() = default;
+
+        ResourceCache &operator=(const ResourceCache &) = delete;
+
+        ResourceCache &operator=(ResourceCache &&) = delete;
+
+        std::shared_ptr<ImageView> request_image_view(Image &image, VkImageViewType view_type, VkFormat format = VK_FORMAT_UNDEFINED,
+                                                      uint32_t base_mip_level = 0, uint32_t base_array_layer = 0,
+                                                      uint32_t n_mip_levels = 0, uint32_t n_array_layers = 0);
+
+        std::shared_ptr<Sampler> request_sampler(const VkSamplerCreateInfo &info);
+
+        /// 不支持pImmutableSamplers
+        std::shared_ptr<DescriptorSetLayout> request_descriptor_set_layout(const std::vector<VkDescriptorSetLayoutBinding> &bindings);
+
+        std::shared_ptr<PipelineLayout> request_pipeline_layout(const std::vector<std::shared_ptr<DescriptorSetLayout>> &set_layouts,
+                                                                const std::vector<VkPushConstantRange> &push_constant_ranges);
+
+        /// 由合并了所有阶段的反射结果生成布局，中间空缺的集合使用空布局
+        std::shared_ptr<PipelineLayout> request_pipeline_layout(const ShaderReflection &reflection);
+
+        /// 移除引用已经全部释放的条目
+        void prune();
+
+        size_t get_image_view_count() const;
+
+        /// 附件格式、操作和采样数相同的请求共享一个渲染通道
+        std::shared_ptr<RenderPass> request_render_pass(const RenderPassDesc &desc);
+
+        /// 帧缓冲持有视图和渲染通道，视图重新分配后得到新的帧缓冲，旧的在最后一个引用释放时销毁
+        std::shared_ptr<Framebuffer> request_framebuffer(const std::shared_ptr<RenderPass> &render_pass,
+                                                         const std::vector<std::shared_ptr<ImageView>> &attachments,
+                                                         VkExtent2D extent, uint32_t layers = 1);
+
+        size_t get_sampler_count() const;
+
+        size_t get_descriptor_set_layout_count() const;
+
+        size_t get_pipeline_layout_count() const;
+
+        size_t get_render_pass_count() const;
+
+        size_t get_framebuffer_count() const;
+
+    private:
+        struct ImageViewKey
+        {
+            const Image *image;
+
+            VkImageViewType view_type;
+
+            VkFormat format;
+
+            VkImageSubresourceRange subresource_range;
+
+            bool operator==(const ImageViewKey &other) const;
+        };
+
+        struct ImageViewKeyHash
+        {
+            size_t operator()(const ImageViewKey &key) const;
+        };
+
+        struct SamplerKey
+        {
+            VkSamplerCreateInfo info;
+
+            bool operator==(const SamplerKey &other) const;
+        };
+
+        struct SamplerKeyHash
+        {
+            size_t operator()(const SamplerKey &key) const;
+        };
+
+        struct DescriptorSetLayoutKey
+        {
+            /// 按binding排序
+            std::vector<VkDescriptorSetLayoutBinding> bindings;
+
+            bool operator==(const DescriptorSetLayoutKey &other) const;
+        };
+
+        struct DescriptorSetLayoutKeyHash
+        {
+            size_t operator()(const DescriptorSetLayoutKey &key) const;
+        };
+
+        struct PipelineLayoutKey
+        {
+            /// 集合布局已经去重，比较句柄即可
+            std::vector<VkDescriptorSetLayout> set_layouts;
+
+            std::vector<VkPushConstantRange> push_constant_ranges;
+
+            bool operator==(const PipelineLayoutKey &other) const;
+        };
+
+        struct PipelineLayoutKeyHash
+        {
+            size_t operator()(const PipelineLayoutKey &key) const;
+        };
+
+        struct RenderPassKeyHash
+        {
+            size_t operator()(const RenderPassDesc &desc) const;
+        };
+
+        struct FramebufferKey
+        {
+            /// 条目存活时帧缓冲持有渲染通道和视图，句柄不会被复用
+            VkRenderPass render_pass;
+
+            std::vector<VkImageView> attachments;
+
+            VkExtent2D extent;
+
+            uint32_t layers;
+
+            bool operator==(const FramebufferKey &other) const;
+        };
+
+        struct FramebufferKeyHash
+        {
+            size_t operator()(const FramebufferKey &key) const;
+        };
+
+        size_t get_entry_count() const;
+
+        void prune_if_needed();
+
+        void remove_expired();
+
+    private:
+        Device &m_device;
+
+        mutable std::mutex m_mutex;
+
+        std::unordered_map<ImageViewKey, std::weak_ptr<ImageView>, ImageViewKeyHash> m_image_views;
+
+        std::unordered_map<SamplerKey, std::weak_ptr<Sampler>, SamplerKeyHash> m_samplers;
+
+        std::unordered_map<DescriptorSetLayoutKey, std::weak_ptr<DescriptorSetLayout>, DescriptorSetLayoutKeyHash> m_descriptor_set_layouts;
+
+        std::unordered_map<PipelineLayoutKey, std::weak_ptr<PipelineLayout>, PipelineLayoutKeyHash> m_pipeline_layouts;
+
+        std::unordered_map<RenderPassDesc, std::weak_ptr<RenderPass>, RenderPassKeyHash> m_render_passes;
+
+        std::unordered_map<FramebufferKey, std::weak_ptr<Framebuffer>, FramebufferKeyHash> m_framebuffers;
+
+        /// 条目数超过该值时清理一次过期条目
+        size_t m_prune_threshold{64};
+    };
+} // namespace comet
@@ -0,0 +1,35 @@
+#include "comet/vulkan/sampler.h"
+
+#include <stdexcept>
+
+#include "comet/vulkan/device.h"
+
+using namespace comet;
+
+Sampler::Sampler(const Device &device, const VkSamplerCreateInfo &info)
+    : m_device(device)
+{
+    if (vkCreateSampler(m_device.get_handle(), &info, nullptr, &m_handle) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create sampler!");
+    }
+}
+
+Sampler::Sampler(Sampler &&other)
+    : m_device(other.m_device), m_handle(other.m_handle)
+{
+    other.m_handle = VK_NULL_HANDLE;
+}
+
+Sampler::~Sampler()
+{
+    if (m_handle != VK_NULL_HANDLE)
+    {
+        vkDestroySampler(m_device.get_handle(), m_handle, nullptr);
+    }
+}
+
+VkSampler Sampler::get_handle() const
+{
+    return m_handle;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "volk.h"
+
+namespace comet
+{
+    class Device;
+
+    class Sampler
+    {
+    public:
+        Sampler(const Device &device, const VkSamplerCreateInfo &info);
+
+        Sampler(const Sampler &) = delete;
+
+        Sampler(Sampler &&other);
+
+        ~Sampler();
+
+        Sampler &operator=(const Sampler &) = delete;
+
+        Sampler &operator=(Sampler &&) = delete;
+
+        VkSampler get_handle() const;
+
+    private:
+        const Device &m_device;
+
+        VkSampler m_handle{VK_NULL_HANDLE};
+    };
+} // namespace comet
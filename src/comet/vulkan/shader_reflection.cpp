@@ -0,0 +1,800 @@
+#include "comet/vulkan/shader_reflection.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace comet;
+
+namespace
+{
+const uint32_t SPIRV_MAGIC = 0x07230203;
+
+// 用到的SPIR-V操作码、修饰和枚举值，见SPIR-V规范第3章
+enum Op : uint32_t
+{
+    OpName = 5,
+    OpEntryPoint = 15,
+    OpExecutionMode = 16,
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpConstantComposite = 44,
+    OpSpecConstantTrue = 48,
+    OpSpecConstantFalse = 49,
+    OpSpecConstant = 50,
+    OpSpecConstantComposite = 51,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+    OpExecutionModeId = 331,
+};
+
+enum ExecutionMode : uint32_t
+{
+    ExecutionModeLocalSize = 17,
+    ExecutionModeLocalSizeId = 38,
+};
+
+const uint32_t BUILTIN_WORKGROUP_SIZE = 25;
+
+enum Decoration : uint32_t
+{
+    DecorationSpecId = 1,
+    DecorationBlock = 2,
+    DecorationBufferBlock = 3,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBuiltIn = 11,
+    DecorationLocation = 30,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35,
+};
+
+enum StorageClass : uint32_t
+{
+    StorageClassUniformConstant = 0,
+    StorageClassInput = 1,
+    StorageClassUniform = 2,
+    StorageClassPushConstant = 9,
+    StorageClassStorageBuffer = 12,
+};
+
+const uint32_t DIM_BUFFER = 5;
+
+const uint32_t DIM_SUBPASS_DATA = 6;
+
+/// OpTypeImage的Sampled为2表示存储图像
+const uint32_t IMAGE_STORAGE = 2;
+
+/// 一个结果id的类型、常量值、修饰和名字
+struct Id
+{
+    uint32_t opcode{0};
+
+    /// 指针、数组、向量、矩阵的元素类型，变量和常量的类型
+    uint32_t type{0};
+
+    uint32_t storage_class{0};
+
+    /// 标量位宽
+    uint32_t width{0};
+
+    bool is_signed{false};
+
+    /// 向量的分量数、矩阵的列数、数组长度所在的常量id
+    uint32_t count{0};
+
+    /// 结构体的成员类型，复合常量的分量
+    std::vector<uint32_t> members;
+
+    uint32_t dim{0};
+
+    uint32_t sampled{0};
+
+    /// 常量的低32位
+    uint32_t value{0};
+
+    uint32_t set{UINT32_MAX};
+
+    uint32_t binding{UINT32_MAX};
+
+    uint32_t location{UINT32_MAX};
+
+    uint32_t spec_id{UINT32_MAX};
+
+    uint32_t array_stride{0};
+
+    bool block{false};
+
+    bool buffer_block{false};
+
+    bool builtin{false};
+
+    uint32_t builtin_value{0};
+
+    std::vector<uint32_t> member_offsets;
+
+    std::vector<uint32_t> member_matrix_strides;
+
+    std::string name;
+};
+
+std::string read_string(const uint32_t *words, uint32_t word_count)
+{
+    const char *text = reinterpret_cast<const char *>(words);
+    size_t length = 0;
+    while (length < word_count * sizeof(uint32_t) && text[length] != '\0')
+    {
+        length++;
+    }
+    return std::string(text, length);
+}
+
+VkShaderStageFlags to_stage(uint32_t execution_model)
+{
+    switch (execution_model)
+    {
+    case 0:
+        return VK_SHADER_STAGE_VERTEX_BIT;
+    case 1:
+        return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    case 2:
+        return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    case 3:
+        return VK_SHADER_STAGE_GEOMETRY_BIT;
+    case 4:
+        return VK_SHADER_STAGE_FRAGMENT_BIT;
+    case 5:
+        return VK_SHADER_STAGE_COMPUTE_BIT;
+    default:
+        throw std::runtime_error("unsupported shader execution model!");
+    }
+}
+
+void set_member(std::vector<uint32_t> &values, uint32_t member, uint32_t value)
+{
+    if (values.size() <= member)
+    {
+        values.resize(member + 1, 0);
+    }
+    values[member] = value;
+}
+
+/// std140/std430下类型占用的字节数，矩阵的列间距由所在结构体成员的修饰决定
+uint32_t get_type_size(const std::vector<Id> &ids, uint32_t type_id, uint32_t matrix_stride = 0)
+{
+    const auto &type = ids[type_id];
+    switch (type.opcode)
+    {
+    case OpTypeBool:
+        return 4;
+    case OpTypeInt:
+    case OpTypeFloat:
+        return type.width / 8;
+    case OpTypeVector:
+        return type.count * get_type_size(ids, type.type);
+    case OpTypeMatrix:
+        return type.count * (matrix_stride ? matrix_stride : get_type_size(ids, type.type));
+    case OpTypeArray:
+    {
+        uint32_t stride = type.array_stride ? type.array_stride : get_type_size(ids, type.type, matrix_stride);
+        return ids[type.count].value * stride;
+    }
+    case OpTypeStruct:
+    {
+        uint32_t size = 0;
+        for (uint32_t member = 0; member < type.members.size(); ++member)
+        {
+            uint32_t offset = member < type.member_offsets.size() ? type.member_offsets[member] : 0;
+            uint32_t stride = member < type.member_matrix_strides.size() ? type.member_matrix_strides[member] : 0;
+            size = std::max(size, offset + get_type_size(ids, type.members[member], stride));
+        }
+        return size;
+    }
+    default:
+        // 运行时数组等没有固定大小
+        return 0;
+    }
+}
+
+VkFormat get_vertex_format(const std::vector<Id> &ids, uint32_t type_id)
+{
+    const auto &type = ids[type_id];
+    uint32_t components = 1;
+    const Id *scalar = &type;
+    if (type.opcode == OpTypeVector)
+    {
+        components = type.count;
+        scalar = &ids[type.type];
+    }
+
+    if (components < 1 || components > 4)
+    {
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    if (scalar->opcode == OpTypeFloat && scalar->width == 32)
+    {
+        const VkFormat formats[] = {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+        return formats[components - 1];
+    }
+    if (scalar->opcode == OpTypeFloat && scalar->width == 64)
+    {
+        const VkFormat formats[] = {VK_FORMAT_R64_SFLOAT, VK_FORMAT_R64G64_SFLOAT, VK_FORMAT_R64G64B64_SFLOAT, VK_FORMAT_R64G64B64A64_SFLOAT};
+        return formats[components - 1];
+    }
+    if (scalar->opcode == OpTypeInt && scalar->width == 32 && scalar->is_signed)
+    {
+        const VkFormat formats[] = {VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT};
+        return formats[components - 1];
+    }
+    if (scalar->opcode == OpTypeInt && scalar->width == 32)
+    {
+        const VkFormat formats[] = {VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT};
+        return formats[components - 1];
+    }
+
+    return VK_FORMAT_UNDEFINED;
+}
+
+uint32_t get_format_size(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R32_SFLOAT:
+    case VK_FORMAT_R32_SINT:
+    case VK_FORMAT_R32_UINT:
+        return 4;
+    case VK_FORMAT_R32G32_SFLOAT:
+    case VK_FORMAT_R32G32_SINT:
+    case VK_FORMAT_R32G32_UINT:
+    case VK_FORMAT_R64_SFLOAT:
+        return 8;
+    case VK_FORMAT_R32G32B32_SFLOAT:
+    case VK_FORMAT_R32G32B32_SINT:
+    case VK_FORMAT_R32G32B32_UINT:
+        return 12;
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+    case VK_FORMAT_R32G32B32A32_SINT:
+    case VK_FORMAT_R32G32B32A32_UINT:
+    case VK_FORMAT_R64G64_SFLOAT:
+        return 16;
+    case VK_FORMAT_R64G64B64_SFLOAT:
+        return 24;
+    case VK_FORMAT_R64G64B64A64_SFLOAT:
+        return 32;
+    default:
+        return 0;
+    }
+}
+
+/// 变量指向的类型对应的描述符类型，同时剥掉外层数组得到数量
+bool get_descriptor_type(const std::vector<Id> &ids, const Id &variable, VkDescriptorType &descriptor_type, uint32_t &count)
+{
+    count = 1;
+    uint32_t type_id = ids[variable.type].type;
+    while (ids[type_id].opcode == OpTypeArray || ids[type_id].opcode == OpTypeRuntimeArray)
+    {
+        const auto &array = ids[type_id];
+        count = array.opcode == OpTypeArray && count != 0 ? count * ids[array.count].value : 0;
+        type_id = array.type;
+    }
+
+    const auto &type = ids[type_id];
+    switch (type.opcode)
+    {
+    case OpTypeSampler:
+        descriptor_type = VK_DESCRIPTOR_TYPE_SAMPLER;
+        return true;
+    case OpTypeSampledImage:
+        descriptor_type = ids[type.type].dim == DIM_BUFFER ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        return true;
+    case OpTypeImage:
+        if (type.dim == DIM_SUBPASS_DATA)
+        {
+            descriptor_type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        }
+        else if (type.dim == DIM_BUFFER)
+        {
+            descriptor_type = type.sampled == IMAGE_STORAGE ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+        }
+        else
+        {
+            descriptor_type = type.sampled == IMAGE_STORAGE ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        }
+        return true;
+    case OpTypeStruct:
+        // 旧版本的存储缓冲是Uniform存储类加BufferBlock修饰
+        if (variable.storage_class == StorageClassStorageBuffer || type.buffer_block)
+        {
+            descriptor_type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            return true;
+        }
+        if (type.block)
+        {
+            descriptor_type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+} // namespace
+
+ShaderReflection::ShaderReflection(const std::vector<uint32_t> &spirv)
+{
+    if (spirv.size() < 5 || spirv[0] != SPIRV_MAGIC)
+    {
+        throw std::runtime_error("invalid spir-v binary!");
+    }
+
+    // 第4个字是id的上界
+    std::vector<Id> ids(spirv[3]);
+    std::vector<uint32_t> variables;
+    std::vector<uint32_t> spec_constants;
+    bool has_entry_point = false;
+    uint32_t entry_point_id = 0;
+    // 工作组大小依次取自WorkgroupSize内建常量、LocalSizeId、LocalSize
+    std::array<uint32_t, 3> local_size{1, 1, 1};
+    std::array<uint32_t, 3> local_size_ids{0, 0, 0};
+    bool has_local_size_ids = false;
+    uint32_t workgroup_size_id = 0;
+
+    auto get_id = [&ids](uint32_t id) -> Id &
+    {
+        if (id >= ids.size())
+        {
+            throw std::runtime_error("invalid spir-v id!");
+        }
+        return ids[id];
+    };
+
+    for (size_t offset = 5; offset < spirv.size();)
+    {
+        uint32_t word_count = spirv[offset] >> 16;
+        uint32_t opcode = spirv[offset] & 0xffff;
+        if (word_count == 0 || offset + word_count > spirv.size())
+        {
+            throw std::runtime_error("invalid spir-v instruction!");
+        }
+        const uint32_t *operands = &spirv[offset + 1];
+        uint32_t operand_count = word_count - 1;
+        offset += word_count;
+
+        switch (opcode)
+        {
+        case OpName:
+            get_id(operands[0]).name = read_string(operands + 1, operand_count - 1);
+            break;
+        case OpEntryPoint:
+            if (!has_entry_point)
+            {
+                m_stages = to_stage(operands[0]);
+                entry_point_id = operands[1];
+                has_entry_point = true;
+            }
+            break;
+        case OpExecutionMode:
+            if (operands[0] == entry_point_id && operand_count >= 5 && operands[1] == ExecutionModeLocalSize)
+            {
+                local_size = {operands[2], operands[3], operands[4]};
+            }
+            break;
+        case OpExecutionModeId:
+            if (operands[0] == entry_point_id && operand_count >= 5 && operands[1] == ExecutionModeLocalSizeId)
+            {
+                local_size_ids = {operands[2], operands[3], operands[4]};
+                has_local_size_ids = true;
+            }
+            break;
+        case OpTypeBool:
+        case OpTypeSampler:
+            get_id(operands[0]).opcode = opcode;
+            break;
+        case OpTypeInt:
+        {
+            auto &id = get_id(operands[0]);
+            id.opcode = opcode;
+            id.width = operands[1];
+            id.is_signed = operands[2] != 0;
+            break;
+        }
+        case OpTypeFloat:
+        {
+            auto &id = get_id(operands[0]);
+            id.opcode = opcode;
+            id.width = operands[1];
+            break;
+        }
+        case OpTypeVector:
+        case OpTypeMatrix:
+        case OpTypeArray:
+        {
+            auto &id = get_id(operands[0]);
+            id.opcode = opcode;
+            id.type = operands[1];
+            id.count = operands[2];
+            break;
+        }
+        case OpTypeImage:
+        {
+            auto &id = get_id(operands[0]);
+            id.opcode = opcode;
+            id.type = operands[1];
+            id.dim = operands[2];
+            id.sampled = operands[6];
+            break;
+        }
+        case OpTypeSampledImage:
+        case OpTypeRuntimeArray:
+        {
+            auto &id = get_id(operands[0]);
+            id.opcode = opcode;
+            id.type = operands[1];
+            break;
+        }
+        case OpTypeStruct:
+        {
+            auto &id = get_id(operands[0]);
+            id.opcode = opcode;
+            id.members.assign(operands + 1, operands + operand_count);
+            break;
+        }
+        case OpTypePointer:
+        {
+            auto &id = get_id(operands[0]);
+            id.opcode = opcode;
+            id.storage_class = operands[1];
+            id.type = operands[2];
+            break;
+        }
+        case OpConstant:
+        case OpSpecConstant:
+        {
+            auto &id = get_id(operands[1]);
+            id.opcode = opcode;
+            id.type = operands[0];
+            id.value = operands[2];
+            if (opcode == OpSpecConstant)
+            {
+                spec_constants.push_back(operands[1]);
+            }
+            break;
+        }
+        case OpConstantComposite:
+        case OpSpecConstantComposite:
+        {
+            auto &id = get_id(operands[1]);
+            id.opcode = opcode;
+            id.type = operands[0];
+            id.members.assign(operands + 2, operands + operand_count);
+            break;
+        }
+        case OpSpecConstantTrue:
+        case OpSpecConstantFalse:
+        {
+            auto &id = get_id(operands[1]);
+            id.opcode = opcode;
+            id.type = operands[0];
+            spec_constants.push_back(operands[1]);
+            break;
+        }
+        case OpVariable:
+        {
+            auto &id = get_id(operands[1]);
+            id.opcode = opcode;
+            id.type = operands[0];
+            id.storage_class = operands[2];
+            variables.push_back(operands[1]);
+            break;
+        }
+        case OpDecorate:
+        {
+            auto &id = get_id(operands[0]);
+            uint32_t literal = operand_count > 2 ? operands[2] : 0;
+            switch (operands[1])
+            {
+            case DecorationSpecId:
+                id.spec_id = literal;
+                break;
+            case DecorationBlock:
+                id.block = true;
+                break;
+            case DecorationBufferBlock:
+                id.buffer_block = true;
+                break;
+            case DecorationArrayStride:
+                id.array_stride = literal;
+                break;
+            case DecorationBuiltIn:
+                id.builtin = true;
+                id.builtin_value = literal;
+                if (literal == BUILTIN_WORKGROUP_SIZE)
+                {
+                    workgroup_size_id = operands[0];
+                }
+                break;
+            case DecorationLocation:
+                id.location = literal;
+                break;
+            case DecorationBinding:
+                id.binding = literal;
+                break;
+            case DecorationDescriptorSet:
+                id.set = literal;
+                break;
+            default:
+                break;
+            }
+            break;
+        }
+        case OpMemberDecorate:
+        {
+            auto &id = get_id(operands[0]);
+            uint32_t literal = operand_count > 3 ? operands[3] : 0;
+            if (operands[2] == DecorationOffset)
+            {
+                set_member(id.member_offsets, operands[1], literal);
+            }
+            else if (operands[2] == DecorationMatrixStride)
+            {
+                set_member(id.member_matrix_strides, operands[1], literal);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    if (!has_entry_point)
+    {
+        throw std::runtime_error("spir-v binary has no entry point!");
+    }
+
+    for (auto variable_id : variables)
+    {
+        const auto &variable = ids[variable_id];
+        const auto &pointee = ids[ids[variable.type].type];
+
+        switch (variable.storage_class)
+        {
+        case StorageClassUniformConstant:
+        case StorageClassUniform:
+        case StorageClassStorageBuffer:
+        {
+            DescriptorBinding binding{};
+            if (variable.binding == UINT32_MAX || !get_descriptor_type(ids, variable, binding.type, binding.count))
+            {
+                break;
+            }
+            binding.set = variable.set == UINT32_MAX ? 0 : variable.set;
+            binding.binding = variable.binding;
+            binding.stages = m_stages;
+            // 匿名的块用块类型名
+            binding.name = variable.name.empty() ? pointee.name : variable.name;
+            m_bindings.push_back(binding);
+            break;
+        }
+        case StorageClassPushConstant:
+        {
+            // 范围从第一个成员的偏移开始，不同阶段可以使用同一个块的不同部分
+            uint32_t begin = pointee.member_offsets.empty() ? 0 : *std::min_element(pointee.member_offsets.begin(), pointee.member_offsets.end());
+            uint32_t end = get_type_size(ids, ids[variable.type].type);
+            if (end > begin)
+            {
+                m_push_constant_ranges.push_back({m_stages, begin, end - begin});
+            }
+            break;
+        }
+        case StorageClassInput:
+        {
+            if (m_stages != VK_SHADER_STAGE_VERTEX_BIT || variable.builtin || pointee.builtin || variable.location == UINT32_MAX)
+            {
+                break;
+            }
+            m_vertex_inputs.push_back({variable.location, get_vertex_format(ids, ids[variable.type].type), variable.name});
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    for (auto constant_id : spec_constants)
+    {
+        const auto &constant = ids[constant_id];
+        if (constant.spec_id == UINT32_MAX)
+        {
+            continue;
+        }
+        m_specialization_constants.push_back({constant.spec_id, get_type_size(ids, constant.type), m_stages, constant.name});
+    }
+
+    if (m_stages == VK_SHADER_STAGE_COMPUTE_BIT)
+    {
+        // 分量是常量或特化常量，特化常量的值是着色器中的默认值
+        auto read_constants = [this, &get_id](const std::vector<uint32_t> &constant_ids)
+        {
+            for (size_t axis = 0; axis < 3 && axis < constant_ids.size(); ++axis)
+            {
+                const auto &constant = get_id(constant_ids[axis]);
+                m_workgroup_size.size[axis] = constant.value;
+                m_workgroup_size.spec_ids[axis] = constant.opcode == OpSpecConstant ? constant.spec_id : UINT32_MAX;
+            }
+        };
+
+        if (workgroup_size_id != 0)
+        {
+            read_constants(get_id(workgroup_size_id).members);
+        }
+        else if (has_local_size_ids)
+        {
+            read_constants({local_size_ids.begin(), local_size_ids.end()});
+        }
+        else
+        {
+            m_workgroup_size.size = local_size;
+        }
+    }
+
+    std::sort(m_bindings.begin(), m_bindings.end(), [](const DescriptorBinding &a, const DescriptorBinding &b)
+              { return a.set != b.set ? a.set < b.set : a.binding < b.binding; });
+    std::sort(m_vertex_inputs.begin(), m_vertex_inputs.end(), [](const VertexInput &a, const VertexInput &b)
+              { return a.location < b.location; });
+    std::sort(m_specialization_constants.begin(), m_specialization_constants.end(), [](const SpecializationConstant &a, const SpecializationConstant &b)
+              { return a.id < b.id; });
+}
+
+void ShaderReflection::merge(const ShaderReflection &other)
+{
+    m_stages |= other.m_stages;
+
+    for (const auto &binding : other.m_bindings)
+    {
+        auto found = std::find_if(m_bindings.begin(), m_bindings.end(), [&binding](const DescriptorBinding &existing)
+                                  { return existing.set == binding.set && existing.binding == binding.binding; });
+        if (found == m_bindings.end())
+        {
+            m_bindings.push_back(binding);
+            continue;
+        }
+
+        if (found->type != binding.type || found->count != binding.count)
+        {
+            throw std::runtime_error("descriptor binding " + binding.name + " differs between shader stages!");
+        }
+        found->stages |= binding.stages;
+    }
+    std::sort(m_bindings.begin(), m_bindings.end(), [](const DescriptorBinding &a, const DescriptorBinding &b)
+              { return a.set != b.set ? a.set < b.set : a.binding < b.binding; });
+
+    // 一个范围覆盖所有阶段，vkCmdPushConstants时使用合并后的阶段标志
+    for (const auto &range : other.m_push_constant_ranges)
+    {
+        if (m_push_constant_ranges.empty())
+        {
+            m_push_constant_ranges.push_back(range);
+            continue;
+        }
+
+        auto &merged = m_push_constant_ranges.front();
+        uint32_t begin = std::min(merged.offset, range.offset);
+        uint32_t end = std::max(merged.offset + merged.size, range.offset + range.size);
+        merged.stageFlags |= range.stageFlags;
+        merged.offset = begin;
+        merged.size = end - begin;
+    }
+
+    if (m_vertex_inputs.empty())
+    {
+        m_vertex_inputs = other.m_vertex_inputs;
+    }
+
+    if (other.m_stages & VK_SHADER_STAGE_COMPUTE_BIT)
+    {
+        m_workgroup_size = other.m_workgroup_size;
+    }
+
+    for (const auto &constant : other.m_specialization_constants)
+    {
+        auto found = std::find_if(m_specialization_constants.begin(), m_specialization_constants.end(), [&constant](const SpecializationConstant &existing)
+                                  { return existing.id == constant.id; });
+        if (found == m_specialization_constants.end())
+        {
+            m_specialization_constants.push_back(constant);
+            continue;
+        }
+
+        if (found->size != constant.size)
+        {
+            throw std::runtime_error("specialization constant " + constant.name + " differs between shader stages!");
+        }
+        found->stages |= constant.stages;
+    }
+    std::sort(m_specialization_constants.begin(), m_specialization_constants.end(), [](const SpecializationConstant &a, const SpecializationConstant &b)
+              { return a.id < b.id; });
+}
+
+VkShaderStageFlags ShaderReflection::get_stages() const
+{
+    return m_stages;
+}
+
+const std::vector<DescriptorBinding> &ShaderReflection::get_bindings() const
+{
+    return m_bindings;
+}
+
+uint32_t ShaderReflection::get_set_count() const
+{
+    return m_bindings.empty() ? 0 : m_bindings.back().set + 1;
+}
+
+std::vector<VkDescriptorSetLayoutBinding> ShaderReflection::get_set_layout_bindings(uint32_t set) const
+{
+    std::vector<VkDescriptorSetLayoutBinding> layout_bindings;
+    for (const auto &binding : m_bindings)
+    {
+        if (binding.set == set)
+        {
+            layout_bindings.push_back({binding.binding, binding.type, binding.count, binding.stages, nullptr});
+        }
+    }
+    return layout_bindings;
+}
+
+const std::vector<VkPushConstantRange> &ShaderReflection::get_push_constant_ranges() const
+{
+    return m_push_constant_ranges;
+}
+
+const std::vector<VertexInput> &ShaderReflection::get_vertex_inputs() const
+{
+    return m_vertex_inputs;
+}
+
+VkVertexInputBindingDescription ShaderReflection::get_vertex_binding(uint32_t binding) const
+{
+    uint32_t stride = 0;
+    for (const auto &input : m_vertex_inputs)
+    {
+        stride += get_format_size(input.format);
+    }
+    return {binding, stride, VK_VERTEX_INPUT_RATE_VERTEX};
+}
+
+std::vector<VkVertexInputAttributeDescription> ShaderReflection::get_vertex_attributes(uint32_t binding) const
+{
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    uint32_t offset = 0;
+    for (const auto &input : m_vertex_inputs)
+    {
+        attributes.push_back({input.location, binding, input.format, offset});
+        offset += get_format_size(input.format);
+    }
+    return attributes;
+}
+
+const std::vector<SpecializationConstant> &ShaderReflection::get_specialization_constants() const
+{
+    return m_specialization_constants;
+}
+
+const WorkgroupSize &ShaderReflection::get_workgroup_size() const
+{
+    return m_workgroup_size;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "volk.h"
+
+namespace comet
+{
+    struct DescriptorBinding
+    {
+        uint32_t set;
+
+        uint32_t binding;
+
+        VkDescriptorType type;
+
+        /// 数组的元素数量，运行时数组为0，需要调用者决定
+        uint32_t count;
+
+        VkShaderStageFlags stages;
+
+        std::string name;
+    };
+
+    struct VertexInput
+    {
+        uint32_t location;
+
+        VkFormat format;
+
+        std::string name;
+    };
+
+    struct SpecializationConstant
+    {
+        uint32_t id;
+
+        /// 布尔常量按VkBool32计算为4字节
+        uint32_t size;
+
+        VkShaderStageFlags stages;
+
+        std::string name;
+    };
+
+    /// 计算着色器的工作组大小
+    struct WorkgroupSize
+    {
+        std::array<uint32_t, 3> size{1, 1, 1};
+
+        /// 由特化常量(local_size_x_id等)决定的维度的常量ID，其余为UINT32_MAX，size是着色器中的默认值
+        std::array<uint32_t, 3> spec_ids{UINT32_MAX, UINT32_MAX, UINT32_MAX};
+    };
+
+    /// 直接解析SPIR-V二进制，得到描述符绑定、推送常量、顶点输入、特化常量和工作组大小。
+    /// 多个阶段merge后可以生成整个管线的布局，手写的布局不会再与着色器不一致
+    class ShaderReflection
+    {
+    public:
+        ShaderReflection() = default;
+
+        /// 只处理第一个入口点对应的阶段，SPIR-V格式错误时抛出异常
+        explicit ShaderReflection(const std::vector<uint32_t> &spirv);
+
+        /// 合并另一个阶段：相同(set, binding)的阶段标志取并集，类型或数量不一致时抛出异常；
+        /// 推送常量合并为覆盖所有阶段的一个范围
+        void merge(const ShaderReflection &other);
+
+        VkShaderStageFlags get_stages() const;
+
+        /// 按(set, binding)排序
+        const std::vector<DescriptorBinding> &get_bindings() const;
+
+        /// 用到的最大set加一，中间没有绑定的set是空布局
+        uint32_t get_set_count() const;
+
+        std::vector<VkDescriptorSetLayoutBinding> get_set_layout_bindings(uint32_t set) const;
+
+        const std::vector<VkPushConstantRange> &get_push_constant_ranges() const;
+
+        /// 顶点着色器的输入，按location排序
+        const std::vector<VertexInput> &get_vertex_inputs() const;
+
+        /// 假设所有顶点输入按location顺序紧密排列在同一个交错的绑定中
+        VkVertexInputBindingDescription get_vertex_binding(uint32_t binding = 0) const;
+
+        std::vector<VkVertexInputAttributeDescription> get_vertex_attributes(uint32_t binding = 0) const;
+
+        /// 按id排序
+        const std::vector<SpecializationConstant> &get_specialization_constants() const;
+
+        /// 只对计算着色器有意义
+        const WorkgroupSize &get_workgroup_size() const;
+
+    private:
+        VkShaderStageFlags m_stages{0};
+
+        std::vector<DescriptorBinding> m_bindings;
+
+        std::vector<VkPushConstantRange> m_push_constant_ranges;
+
+        std::vector<VertexInput> m_vertex_inputs;
+
+        std::vector<SpecializationConstant> m_specialization_constants;
+
+        WorkgroupSize m_workgroup_size;
+    };
+} // namespace comet
@@ -0,0 +1,93 @@
+#include "comet/vulkan/specialization_constants.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "comet/vulkan/shader_reflection.h"
+
+using namespace comet;
+
+void SpecializationConstants::set_data(uint32_t constant_id, const void *data, size_t size)
+{
+    auto found = std::lower_bound(m_entries.begin(), m_entries.end(), constant_id, [](const VkSpecializationMapEntry &entry, uint32_t id)
+                                  { return entry.constantID < id; });
+
+    if (found != m_entries.end() && found->constantID == constant_id)
+    {
+        if (found->size != size)
+        {
+            throw std::runtime_error("specialization constant " + std::to_string(constant_id) + " changed size!");
+        }
+        std::memcpy(m_data.data() + found->offset, data, size);
+        return;
+    }
+
+    // 数据按条目顺序紧密排列，插入时后面的偏移整体后移
+    uint32_t offset = found == m_entries.end() ? static_cast<uint32_t>(m_data.size()) : found->offset;
+    auto bytes = static_cast<const uint8_t *>(data);
+    m_data.insert(m_data.begin() + offset, bytes, bytes + size);
+    for (auto it = found; it != m_entries.end(); ++it)
+    {
+        it->offset += static_cast<uint32_t>(size);
+    }
+    m_entries.insert(found, {constant_id, offset, size});
+}
+
+bool SpecializationConstants::empty() const
+{
+    return m_entries.empty();
+}
+
+VkSpecializationInfo SpecializationConstants::get_info() const
+{
+    VkSpecializationInfo info{};
+    info.mapEntryCount = static_cast<uint32_t>(m_entries.size());
+    info.pMapEntries = m_entries.data();
+    info.dataSize = m_data.size();
+    info.pData = m_data.data();
+    return info;
+}
+
+const std::vector<VkSpecializationMapEntry> &SpecializationConstants::get_entries() const
+{
+    return m_entries;
+}
+
+const std::vector<uint8_t> &SpecializationConstants::get_data() const
+{
+    return m_data;
+}
+
+void SpecializationConstants::check(const ShaderReflection &reflection) const
+{
+    const auto &declared = reflection.get_specialization_constants();
+    for (const auto &entry : m_entries)
+    {
+        auto found = std::find_if(declared.begin(), declared.end(), [&entry](const SpecializationConstant &constant)
+                                  { return constant.id == entry.constantID; });
+        if (found == declared.end())
+        {
+            throw std::runtime_error("specialization constant " + std::to_string(entry.constantID) + " is not declared by the shader!");
+        }
+        // 反射得到的bool大小为4，与VkBool32一致
+        if (found->size != entry.size)
+        {
+            throw std::runtime_error("specialization constant " + found->name + " has size " + std::to_string(found->size) +
+                                     " in the shader but " + std::to_string(entry.size) + " is set!");
+        }
+    }
+}
+
+bool SpecializationConstants::operator==(const SpecializationConstants &other) const
+{
+    return m_data == other.m_data &&
+           std::equal(m_entries.begin(), m_entries.end(), other.m_entries.begin(), other.m_entries.end(),
+                      [](const VkSpecializationMapEntry &a, const VkSpecializationMapEntry &b)
+                      { return a.constantID == b.constantID && a.offset == b.offset && a.size == b.size; });
+}
+
+bool SpecializationConstants::operator!=(const SpecializationConstants &other) const
+{
+    return !(*this == other);
+}
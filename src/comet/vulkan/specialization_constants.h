@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "volk.h"
+
+namespace comet
+{
+    class ShaderReflection;
+
+    /// 一个着色器阶段的特化常量值，生成VkSpecializationInfo。
+    /// 条目按constant_id排序，设置顺序不影响比较结果，可以作为管线变体的键
+    class SpecializationConstants
+    {
+    public:
+        /// bool按VkBool32保存，其余类型必须是4或8字节的标量
+        template <typename T>
+        void set(uint32_t constant_id, const T &value)
+        {
+            if constexpr (std::is_same<T, bool>::value)
+            {
+                VkBool32 bool_value = value ? VK_TRUE : VK_FALSE;
+                set_data(constant_id, &bool_value, sizeof(bool_value));
+            }
+            else
+            {
+                static_assert(std::is_arithmetic<T>::value && (sizeof(T) == 4 || sizeof(T) == 8),
+                              "specialization constants must be 32 or 64 bit scalars");
+                set_data(constant_id, &value, sizeof(T));
+            }
+        }
+
+        void set_data(uint32_t constant_id, const void *data, size_t size);
+
+        bool empty() const;
+
+        /// 指向内部数据，修改后失效
+        VkSpecializationInfo get_info() const;
+
+        const std::vector<VkSpecializationMapEntry> &get_entries() const;
+
+        const std::vector<uint8_t> &get_data() const;
+
+        /// 每个常量都必须由着色器声明且大小一致，否则抛出异常。驱动会静默忽略未声明的常量
+        void check(const ShaderReflection &reflection) const;
+
+        bool operator==(const SpecializationConstants &other) const;
+
+        bool operator!=(const SpecializationConstants &other) const;
+
+    private:
+        std::vector<VkSpecializationMapEntry> m_entries;
+
+        std::vector<uint8_t> m_data;
+    };
+} // namespace comet
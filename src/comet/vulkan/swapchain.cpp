@@ -9,7 +9,7 @@ using namespace comet;
 
 inline VkSurfaceFormatKHR choose_surface_format(VkSurfaceFormatKHR required, const std::vector<VkSurfaceFormatKHR> &available);
 
-inline VkPresentModeKHR choose_present_mode(const VkPresentModeKHR &required, const std::vector<VkPresentModeKHR> &available);
+inline VkPresentModeKHR choose_present_mode(const VkPresentModeKHR &required, const std::vector<VkPresentModeKHR> &available, const std::vector<VkPresentModeKHR> &priority_list);
 
 inline VkExtent2D choose_extent(VkExtent2D required, const VkSurfaceCapabilitiesKHR &capabilities);
 
@@ -39,6 +39,25 @@ Swapchain::Swapchain(Device &device, const VkSurfaceKHR &surface,
 {
 }
 
+Swapchain::Swapchain(Swapchain &old_swapchain, const VkExtent2D &extent)
+    : Swapchain(old_swapchain, extent, old_swapchain.m_properties.present_mode, {old_swapchain.m_properties.present_mode})
+{
+}
+
+Swapchain::Swapchain(Swapchain &old_swapchain, const VkExtent2D &extent,
+                     const VkPresentModeKHR &present_mode,
+                     const std::vector<VkPresentModeKHR> &present_mode_priority_list)
+    : Swapchain(old_swapchain, old_swapchain.m_device, old_swapchain.m_surface,
+                present_mode, present_mode_priority_list,
+                old_swapchain.m_properties.surface_format, {old_swapchain.m_properties.surface_format},
+                extent,
+                old_swapchain.m_properties.image_count,
+                old_swapchain.m_properties.array_layers,
+                old_swapchain.m_properties.pre_transform,
+                old_swapchain.m_image_usage_flags)
+{
+}
+
 Swapchain::Swapchain(Swapchain &old_swapchain, Device &device, const VkSurfaceKHR &surface,
                      const VkPresentModeKHR &present_mode,
                      const std::vector<VkPresentModeKHR> &present_mode_priority_list,
@@ -71,10 +90,10 @@ Swapchain::Swapchain(Swapchain &old_swapchain, Device &device, const VkSurfaceKH
     m_properties.surface_format = choose_surface_format(surface_format, m_surface_formats);
 
     // 选择呈现模式
-    m_properties.present_mode = choose_present_mode(present_mode, m_present_modes);
+    m_properties.present_mode = choose_present_mode(present_mode, m_present_modes, present_mode_priority_list);
 
     // 选择分辨率
-    m_properties.extent = choose_extent({800, 600}, surface_capabilities);
+    m_properties.extent = choose_extent(extent, surface_capabilities);
 
     // 选择图像数量
     m_properties.image_count = choose_image_count(image_count, surface_capabilities);
@@ -128,6 +147,23 @@ Swapchain::~Swapchain()
     vkDestroySwapchainKHR(m_device.get_handle(), m_handle, nullptr);
 }
 
+VkResult Swapchain::acquire_next_image(uint32_t &image_index, VkSemaphore image_acquired_semaphore, VkFence fence)
+{
+    return vkAcquireNextImageKHR(m_device.get_handle(), m_handle, UINT64_MAX, image_acquired_semaphore, fence, &image_index);
+}
+
+VkResult Swapchain::present(VkQueue queue, uint32_t image_index, VkSemaphore wait_semaphore)
+{
+    VkPresentInfoKHR present_info{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+    present_info.waitSemaphoreCount = wait_semaphore != VK_NULL_HANDLE ? 1 : 0;
+    present_info.pWaitSemaphores = &wait_semaphore;
+    present_info.swapchainCount = 1;
+    present_info.pSwapchains = &m_handle;
+    present_info.pImageIndices = &image_index;
+
+    return vkQueuePresentKHR(queue, &present_info);
+}
+
 VkSwapchainKHR Swapchain::get_handle() const
 {
     return m_handle;
@@ -153,6 +189,16 @@ VkImageUsageFlags Swapchain::get_usage() const
     return m_properties.image_usage;
 }
 
+VkImageLayout Swapchain::get_present_layout() const
+{
+    return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
+VkPresentModeKHR Swapchain::get_present_mode() const
+{
+    return m_properties.present_mode;
+}
+
 VkSurfaceFormatKHR choose_surface_format(VkSurfaceFormatKHR required, const std::vector<VkSurfaceFormatKHR> &available)
 {
     auto find_result = std::find_if(available.begin(), available.end(), [&](const VkSurfaceFormatKHR &available)
@@ -170,29 +216,31 @@ VkSurfaceFormatKHR choose_surface_format(VkSurfaceFormatKHR required, const std:
     }
 }
 
-VkPresentModeKHR choose_present_mode(const VkPresentModeKHR &required, const std::vector<VkPresentModeKHR> &available)
+VkPresentModeKHR choose_present_mode(const VkPresentModeKHR &required, const std::vector<VkPresentModeKHR> &available, const std::vector<VkPresentModeKHR> &priority_list)
 {
     auto find_result = std::find(available.begin(), available.end(), required);
     if (find_result != available.end())
     {
         return required;
     }
-    else
+
+    // 按优先级列表依次查找
+    for (auto present_mode : priority_list)
     {
-        // TODO: 提供一个可配置的默认值
-        // 默认返回FIFO模式
-        return VK_PRESENT_MODE_FIFO_KHR;
+        if (std::find(available.begin(), available.end(), present_mode) != available.end())
+        {
+            return present_mode;
+        }
     }
+
+    // FIFO模式一定支持
+    return VK_PRESENT_MODE_FIFO_KHR;
 }
 
 VkExtent2D choose_extent(VkExtent2D required, const VkSurfaceCapabilitiesKHR &capabilities)
 {
-    if (capabilities.currentExtent.width == UINT32_MAX)
-    {
-        return required;
-    }
-
-    if (required.width < 1 || required.height < 1)
+    // currentExtent为0xFFFFFFFF时表示由交换链决定表面大小
+    if ((required.width < 1 || required.height < 1) && capabilities.currentExtent.width != UINT32_MAX)
     {
         return capabilities.currentExtent;
     }
@@ -205,7 +253,9 @@ VkExtent2D choose_extent(VkExtent2D required, const VkSurfaceCapabilitiesKHR &ca
 
 uint32_t choose_image_count(uint32_t required, const VkSurfaceCapabilitiesKHR &capabilities)
 {
-    return std::min(std::max(required, capabilities.minImageCount), capabilities.maxImageCount);
+    // maxImageCount为0表示没有上限
+    uint32_t count = std::max(required, capabilities.minImageCount);
+    return capabilities.maxImageCount > 0 ? std::min(count, capabilities.maxImageCount) : count;
 }
 
 uint32_t choose_array_layers(uint32_t required, const VkSurfaceCapabilitiesKHR &capabilities)
@@ -5,6 +5,8 @@
 
 #include "volk.h"
 
+#include "comet/vulkan/presenter.h"
+
 namespace comet
 {
 	class Device;
@@ -31,7 +33,7 @@ namespace comet
 		VkPresentModeKHR present_mode;
 	};
 
-	class Swapchain
+	class Swapchain : public Presenter
 	{
 	public:
 		Swapchain(Device &device, const VkSurfaceKHR &surface,
@@ -60,17 +62,33 @@ namespace comet
 				  const VkSurfaceTransformFlagBitsKHR transform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
 				  const std::set<VkImageUsageFlagBits> &image_usage_flags = {VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_USAGE_TRANSFER_SRC_BIT});
 
-		~Swapchain();
+		/// 沿用old_swapchain的设置，仅改变分辨率，旧交换链作为oldSwapchain传入
+		Swapchain(Swapchain &old_swapchain, const VkExtent2D &extent);
+
+		/// 同时改变分辨率和呈现模式
+		Swapchain(Swapchain &old_swapchain, const VkExtent2D &extent,
+				  const VkPresentModeKHR &present_mode,
+				  const std::vector<VkPresentModeKHR> &present_mode_priority_list);
+
+		~Swapchain() override;
+
+		VkResult acquire_next_image(uint32_t &image_index, VkSemaphore image_acquired_semaphore, VkFence fence = VK_NULL_HANDLE) override;
+
+		VkResult present(VkQueue queue, uint32_t image_index, VkSemaphore wait_semaphore) override;
 
 		VkSwapchainKHR get_handle() const;
 
-		const std::vector<VkImage> &get_images() const;
+		const std::vector<VkImage> &get_images() const override;
+
+		VkFormat get_format() const override;
+
+		const VkExtent2D &get_extent() const override;
 
-		VkFormat get_format() const;
+		VkImageUsageFlags get_usage() const override;
 
-		const VkExtent2D &get_extent() const;
+		VkImageLayout get_present_layout() const override;
 
-		VkImageUsageFlags get_usage() const;
+		VkPresentModeKHR get_present_mode() const;
 
 	private:
 		Device &m_device;
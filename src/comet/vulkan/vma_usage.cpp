@@ -1,2 +1,7 @@
+#include "volk.h"
+
+// 函数指针由Device通过vkGetInstanceProcAddr/vkGetDeviceProcAddr提供
+#define VMA_STATIC_VULKAN_FUNCTIONS 0
+#define VMA_DYNAMIC_VULKAN_FUNCTIONS 1
 #define VMA_IMPLEMENTATION
 #include "comet/vulkan/vma_usage.h"
\ No newline at end of file